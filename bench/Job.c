@@ -0,0 +1,157 @@
+/*
+ * measures the job system for growing worker counts: a recursive fork-join tree that only
+ * spreads by stealing, a ParallelFor over a large array, and jobs that workers hand to the
+ * main-thread queue. also checks that every job ran, including jobs still queued at DeInit.
+ */
+#include <Rogue/Core.h>
+#include <Rogue/Job.h>
+#include <stdio.h>
+
+#define TREE_DEPTH 16 /* 2^17 - 1 jobs per tree. */
+#define TREE_JOBS ((RgSize)(2 << TREE_DEPTH) - 1)
+#define TREES 10
+#define ARRAY_SIZE (1 << 22)
+#define LOOPS 20
+#define MAIN_SENDERS 64
+#define MAIN_JOBS_PER_SENDER 256
+#define DEINIT_JOBS 10000
+
+typedef struct {
+	RgJobSystem *jobs;
+	RgJobCounter *counter;
+	atomic_size_t *ran;
+	RgSize depth;
+} TreeNode;
+
+/* spawns both children against the same counter, so only thieves can spread the tree. */
+static void TreeJob(void *data) {
+	TreeNode *node = data;
+	atomic_fetch_add_explicit(node->ran, 1, memory_order_relaxed);
+	if (node->depth == 0) return;
+
+	TreeNode *children = RgAllocArray(sizeof(*children), 2);
+	if (children == NULL) RgFail("Failed to allocate tree nodes.");
+	for (RgSize i = 0; i < 2; ++i) {
+		children[i] = *node;
+		children[i].depth = node->depth - 1;
+	}
+	RgJobCounter counter = {0};
+	RgJobSystem_Spawn(node->jobs, &TreeJob, &children[0], &counter);
+	RgJobSystem_Spawn(node->jobs, &TreeJob, &children[1], &counter);
+	RgJobSystem_Wait(node->jobs, &counter);
+	RgDeAlloc(children);
+}
+
+typedef struct {
+	const uint32_t *values;
+	uint64_t *sums; /* one per sub-range start, so no two sub-ranges write the same slot. */
+	RgSize grain;
+} SumLoop;
+
+static void SumRange(void *data, RgSize begin, RgSize end) {
+	SumLoop *loop = data;
+	uint64_t sum = 0;
+	for (RgSize i = begin; i < end; ++i) {
+		// a little arithmetic per element, so the loop isn't only memory bound:
+		uint64_t x = loop->values[i];
+		x ^= x >> 7; x *= 0x9E3779B97F4A7C15ull; x ^= x >> 29;
+		sum += x & 0xFFFF;
+	}
+	loop->sums[begin / loop->grain] = sum;
+}
+
+typedef struct {
+	RgJobSystem *jobs;
+	RgJobCounter *counter;
+	atomic_size_t *ran;
+} MainSender;
+
+static void CountJob(void *data) {
+	atomic_fetch_add_explicit((atomic_size_t *)data, 1, memory_order_relaxed);
+}
+
+/* runs on any worker and hands its jobs to the main thread. */
+static void SendToMain(void *data) {
+	MainSender *sender = data;
+	for (RgSize i = 0; i < MAIN_JOBS_PER_SENDER; ++i)
+		RgJobSystem_SpawnMain(sender->jobs, &CountJob, sender->ran, sender->counter);
+}
+
+int main(void) {
+	static const RgSize workerCounts[] = { 1, 2, 4, 8 };
+
+	uint32_t *values = RgAllocArray(sizeof(*values), ARRAY_SIZE);
+	if (values == NULL) RgFail("Failed to allocate the bench array.");
+	for (RgSize i = 0; i < ARRAY_SIZE; ++i)
+		values[i] = (uint32_t)(i * 2654435761u);
+
+	printf("%8s %12s %10s %12s %10s %12s %8s\n", "workers", "tree ns/job", "speedup", "for ms", "speedup", "main ns/job", "deinit");
+
+	double treeBase = 0, forBase = 0;
+	uint64_t expectedSum = 0;
+
+	for (RgSize w = 0; w < sizeof(workerCounts) / sizeof(*workerCounts); ++w) {
+		RgJobSystem jobs;
+		RgJobSystem_Init(&jobs, &(RgJobSystemInitInfo){ .workerCount = workerCounts[w] });
+
+		atomic_size_t ran;
+		atomic_init(&ran, 0);
+		uint64_t start = RgTimeNs();
+		for (RgSize t = 0; t < TREES; ++t) {
+			TreeNode root = { .jobs = &jobs, .ran = &ran, .depth = TREE_DEPTH };
+			RgJobCounter counter = {0};
+			RgJobSystem_Spawn(&jobs, &TreeJob, &root, &counter);
+			RgJobSystem_Wait(&jobs, &counter);
+		}
+		double treeNs = (double)(RgTimeNs() - start) / (TREES * TREE_JOBS);
+		if (atomic_load(&ran) != TREES * TREE_JOBS) RgFail("Only %zu of %zu tree jobs ran.", atomic_load(&ran), TREES * TREE_JOBS);
+
+		// a fixed grain, so every worker count sums the same sub-ranges:
+		SumLoop loop = { .values = values, .grain = ARRAY_SIZE / 256 };
+		loop.sums = RgAllocArray(sizeof(*loop.sums), ARRAY_SIZE / loop.grain);
+		if (loop.sums == NULL) RgFail("Failed to allocate the partial sums.");
+		uint64_t sum = 0;
+		start = RgTimeNs();
+		for (RgSize l = 0; l < LOOPS; ++l) {
+			RgJobSystem_ParallelFor(&jobs, 0, ARRAY_SIZE, loop.grain, &SumRange, &loop);
+			sum = 0;
+			for (RgSize i = 0; i < ARRAY_SIZE / loop.grain; ++i)
+				sum += loop.sums[i];
+		}
+		double forMs = (double)(RgTimeNs() - start) / LOOPS / 1e6;
+		RgDeAlloc(loop.sums);
+		if (w == 0) expectedSum = sum;
+		else if (sum != expectedSum) RgFail("ParallelFor with %zu workers summed differently.", workerCounts[w]);
+
+		// every sender spawns against the counter before its own job finishes, so it can't hit zero early:
+		static MainSender senders[MAIN_SENDERS];
+		RgJobCounter mainCounter = {0};
+		atomic_store(&ran, 0);
+		start = RgTimeNs();
+		for (RgSize i = 0; i < MAIN_SENDERS; ++i) {
+			senders[i] = (MainSender){ .jobs = &jobs, .counter = &mainCounter, .ran = &ran };
+			RgJobSystem_Spawn(&jobs, &SendToMain, &senders[i], &mainCounter);
+		}
+		RgJobSystem_Wait(&jobs, &mainCounter);
+		double mainNs = (double)(RgTimeNs() - start) / (MAIN_SENDERS * MAIN_JOBS_PER_SENDER);
+		if (atomic_load(&ran) != MAIN_SENDERS * MAIN_JOBS_PER_SENDER) RgFail("Main-thread jobs went missing.");
+
+		// fire-and-forget jobs nobody waits for must still run before DeInit returns:
+		atomic_store(&ran, 0);
+		for (RgSize i = 0; i < DEINIT_JOBS; ++i) {
+			if (i % 2 == 0) RgJobSystem_Spawn(&jobs, &CountJob, &ran, NULL);
+			else RgJobSystem_SpawnMain(&jobs, &CountJob, &ran, NULL);
+		}
+		RgJobSystem_DeInit(&jobs);
+		bool drained = atomic_load(&ran) == DEINIT_JOBS;
+
+		if (w == 0) {
+			treeBase = treeNs;
+			forBase = forMs;
+		}
+		printf("%8zu %12.1f %9.2fx %12.3f %9.2fx %12.1f %8s\n", workerCounts[w],
+			treeNs, treeBase / treeNs, forMs, forBase / forMs, mainNs, drained ? "ok" : "DROPPED");
+	}
+
+	RgDeAlloc(values);
+}
@@ -0,0 +1,90 @@
+/*
+ * measures relighting after one light moves against relighting every light, for growing numbers
+ * of lights in a 128x128 tile window with scattered walls. after the moves, a full rebuild must
+ * accumulate exactly the same light as the incremental updates did.
+ */
+#include <Rogue/Core.h>
+#include <Rogue/World.h>
+#include <Rogue/Light.h>
+#include <Rogue/Random.h>
+#include <stdio.h>
+
+#define AREA 128 /* window side in tiles, a whole number of chunks. */
+#define MOVES 10000
+#define REBUILDS 100
+#define RADIUS 8
+
+static void FillWorld(RgWorld *world) {
+	for (int32_t cy = 0; cy < AREA / RG_CHUNK_SIZE; ++cy)
+	for (int32_t cx = 0; cx < AREA / RG_CHUNK_SIZE; ++cx) {
+		RgChunk *chunk = RgWorld_AddChunk(world, cx, cy);
+		// about one wall in ten:
+		for (RgSize t = 0; t < RG_CHUNK_AREA; ++t)
+			chunk->tiles[t] = RgRng_Below(&world->rng, 10) == 0
+				? (RgTile){ .glyph = '#', .flags = RG_TILE_FLAG_OPAQUE | RG_TILE_FLAG_SOLID }
+				: (RgTile){ .glyph = '.' };
+	}
+}
+
+/* a random step of at most one tile, kept inside the window. */
+static inline int32_t Step(RgRng *rng, int32_t coord) {
+	coord += (int32_t)RgRng_Below(rng, 3) - 1;
+	return coord < 0 ? 0 : coord >= AREA ? AREA - 1 : coord;
+}
+
+int main(void) {
+	static const RgSize counts[] = { 50, 200, 800 };
+
+	printf("%8s %12s %12s %10s\n", "lights", "move us", "rebuild us", "speedup");
+
+	for (RgSize c = 0; c < sizeof(counts) / sizeof(*counts); ++c) {
+		RgWorld world;
+		RgWorld_Init(&world, 99);
+		FillWorld(&world);
+
+		RgLightMap map;
+		RgLightMap_Init(&map, AREA, AREA, 0x101010);
+		RgLightMap_SetOrigin(&map, 0, 0, &world);
+
+		RgLight *lights = RgAllocArray(sizeof(*lights), counts[c]);
+		for (RgSize i = 0; i < counts[c]; ++i) {
+			lights[i] = (RgLight){
+				.x = (int32_t)RgRng_Below(&world.rng, AREA), .y = (int32_t)RgRng_Below(&world.rng, AREA),
+				.radius = RADIUS, .color = (RgPixel)RgRng_Below(&world.rng, 0x1000000),
+			};
+			RgLightMap_Add(&map, &lights[i]);
+		}
+		RgLightMap_Update(&map);
+
+		uint64_t start = RgTimeNs();
+		for (RgSize m = 0; m < MOVES; ++m) {
+			RgLight *light = &lights[RgRng_Below(&world.rng, (uint32_t)counts[c])];
+			RgLightMap_Move(&map, light, Step(&world.rng, light->x), Step(&world.rng, light->y));
+			RgLightMap_Update(&map);
+		}
+		double moveUs = (double)(RgTimeNs() - start) / MOVES / 1e3;
+
+		// keep what the moves accumulated, then relight everything from scratch:
+		RgSize accumSize = sizeof(*map.accum) * 4 * AREA * AREA;
+		uint32_t *accum = RgAlloc(accumSize);
+		if (accum == NULL) RgFail("Failed to allocate the accumulator copy.");
+		__builtin_memcpy(accum, map.accum, accumSize);
+
+		start = RgTimeNs();
+		for (RgSize r = 0; r < REBUILDS; ++r) {
+			RgLightMap_SetOrigin(&map, 0, 0, &world);
+			RgLightMap_Update(&map);
+		}
+		double rebuildUs = (double)(RgTimeNs() - start) / REBUILDS / 1e3;
+
+		if (__builtin_memcmp(accum, map.accum, accumSize) != 0)
+			RgFail("Incremental updates with %zu lights drifted from a full rebuild.", counts[c]);
+
+		printf("%8zu %12.2f %12.2f %9.0fx\n", counts[c], moveUs, rebuildUs, rebuildUs / moveUs);
+
+		RgDeAlloc(accum);
+		RgLightMap_DeInit(&map);
+		RgDeAlloc(lights);
+		RgWorld_DeInit(&world);
+	}
+}
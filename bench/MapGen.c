@@ -0,0 +1,64 @@
+/*
+ * measures chunk generation time per region type, and how long the streamer takes to fill a
+ * square of chunks for growing worker counts. also checks that every worker count produces
+ * byte-identical chunks.
+ */
+#include <Rogue/Core.h>
+#include <Rogue/MapGen.h>
+#include <stdio.h>
+
+#define SEED 1234
+#define RADIUS 8
+#define SIDE (2 * RADIUS + 1)
+
+int main(void) {
+	static RgChunk reference[SIDE * SIDE];
+	static const char *const regionNames[] = { "terrain", "caves", "rooms" };
+	uint64_t regionNs[3] = {0};
+	RgSize regionCount[3] = {0};
+
+	for (int32_t y = -RADIUS; y <= RADIUS; ++y)
+	for (int32_t x = -RADIUS; x <= RADIUS; ++x) {
+		RgMapGenRegion region = RgMapGen_GetRegion(SEED, x, y);
+		uint64_t start = RgTimeNs();
+		RgMapGen_GenerateChunk(SEED, x, y, &reference[(y + RADIUS) * SIDE + (x + RADIUS)]);
+		regionNs[region] += RgTimeNs() - start;
+		++regionCount[region];
+	}
+
+	printf("%10s %8s %12s\n", "region", "chunks", "us/chunk");
+	for (int i = 0; i < 3; ++i)
+		printf("%10s %8zu %12.1f\n", regionNames[i], regionCount[i],
+			regionCount[i] == 0 ? 0.0 : regionNs[i] / 1e3 / regionCount[i]);
+
+	static const RgSize workerCounts[] = { 1, 2, 4, 8 };
+	printf("\n%10s %12s %12s\n", "workers", "ms/square", "identical");
+
+	for (RgSize w = 0; w < sizeof(workerCounts) / sizeof(*workerCounts); ++w) {
+		RgJobSystem jobs;
+		RgJobSystem_Init(&jobs, &(RgJobSystemInitInfo){ .workerCount = workerCounts[w] });
+		RgWorld world;
+		RgWorld_Init(&world, SEED);
+		RgMapStreamer streamer;
+		RgMapStreamer_Init(&streamer, &jobs, SEED);
+
+		uint64_t start = RgTimeNs();
+		RgMapStreamer_RequestAround(&streamer, 0, 0, RADIUS);
+		RgMapStreamer_Flush(&streamer, &world);
+		uint64_t elapsed = RgTimeNs() - start;
+
+		bool identical = world.chunkCount == SIDE * SIDE;
+		for (int32_t y = -RADIUS; y <= RADIUS && identical; ++y)
+		for (int32_t x = -RADIUS; x <= RADIUS && identical; ++x) {
+			const RgChunk *chunk = RgWorld_GetChunk(&world, x, y);
+			identical = chunk != NULL
+				&& __builtin_memcmp(chunk, &reference[(y + RADIUS) * SIDE + (x + RADIUS)], sizeof(*chunk)) == 0;
+		}
+
+		printf("%10zu %12.3f %12s\n", workerCounts[w], elapsed / 1e6, identical ? "yes" : "NO");
+
+		RgMapStreamer_DeInit(&streamer);
+		RgWorld_DeInit(&world);
+		RgJobSystem_DeInit(&jobs);
+	}
+}
@@ -0,0 +1,297 @@
+/*
+ * renderer microbenchmarks against a headless window.
+ * usage: bench-renderer [--json out.json] [--baseline base.json] [--threshold 0.10] [--filter substring]
+ *
+ * every case runs a warmup, then RG_BENCH_REPS timed batches; the median batch is reported.
+ * with --baseline, exits with status 1 if any case got slower than the baseline by more than
+ * the threshold (a fraction of the baseline's ns/cell).
+ */
+#include <Rogue/Core.h>
+#include <Rogue/Window.h>
+#include <Rogue/Renderer.h>
+#include <Rogue/Random.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RG_BENCH_REPS 15
+#define RG_BENCH_WARMUP_NS 20000000ull /* 20 ms. */
+#define RG_BENCH_BATCH_NS 5000000ull /* aim for 5 ms per timed batch. */
+#define RG_BENCH_MAX_CASES 256
+
+typedef enum {
+	DIRTY_CLEAR, /* nothing changes between frames. */
+	DIRTY_SOME, /* 1% of the cells change between frames. */
+	DIRTY_RANDOM, /* every cell is random every frame. */
+} DirtyMode;
+
+static const char *dirtyNames[] = { "clear", "dirty1", "random" };
+
+typedef struct {
+	RgWindow window;
+	RgRenderer renderer;
+	RgFont font;
+	RgSymbol *frames[2]; /* consecutive frames the buffer alternates between. */
+	RgSize frame;
+	RgPixel *light; /* random per-cell light for the lit refresh. */
+} Bench;
+
+typedef struct {
+	char name[96];
+	double nsPerCell;
+	double pixelsPerSec;
+	double nsPerIterMedian, nsPerIterMin;
+} Result;
+
+typedef void BenchFunc(Bench *bench);
+
+static void BenchRefresh(Bench *bench) {
+	bench->renderer.buffer = bench->frames[bench->frame ^= 1];
+	RgRenderer_Refresh(&bench->renderer);
+}
+
+static void BenchRefreshLit(Bench *bench) {
+	bench->renderer.light = bench->light;
+	BenchRefresh(bench);
+	bench->renderer.light = NULL;
+}
+
+static void BenchClear(Bench *bench) {
+	RgRenderer_Clear(&bench->renderer, (char)('a' + (bench->frame ^= 1)), 1);
+}
+
+static void BenchBorder(Bench *bench) {
+	RgRenderer_DrawBorder(&bench->renderer);
+}
+
+static void BenchWindowRefresh(Bench *bench) {
+	RgWindow_Refresh(&bench->window);
+}
+
+static void Bench_Init(Bench *bench, RgSize gridW, RgSize gridH, RgSize cell, DirtyMode dirty) {
+	RgSize margin = 4;
+	RgWindow_Init(&bench->window, &(RgWindowInitInfo){
+		.width = gridW * cell + 2 * margin,
+		.height = gridH * cell + 2 * margin,
+		.scaleX = 1.0f,
+		.scaleY = 1.0f,
+		.headless = true,
+	});
+
+	RgFont_InitBuiltin(&bench->font, cell, cell);
+
+	static RgPixel palette[] = { 0x000000, 0xEEEEEE, 0x2112E2, 0xE22112 };
+
+	RgRenderer_Init(&bench->renderer, &bench->window, gridW, gridH, &bench->font);
+	bench->renderer.palette = palette;
+	bench->renderer.screenOffset.x = margin;
+	bench->renderer.screenOffset.y = margin;
+
+	RgSize cells = gridW * gridH;
+	RgRng rng;
+	RgRng_Init(&rng, 42);
+
+	// the first frame is the renderer's own buffer, so RgRenderer_DeInit frees it:
+	bench->frames[0] = bench->renderer.buffer;
+	bench->frames[1] = RgAllocArray(sizeof(RgSymbol), cells);
+
+	for (int f = 0; f < 2; ++f) {
+		for (RgSize i = 0; i < cells; ++i) {
+			bool randomize = dirty == DIRTY_RANDOM || (f == 1 && dirty == DIRTY_SOME && RgRng_Below(&rng, 100) == 0);
+			bench->frames[f][i] = randomize
+				? (RgSymbol){ .value = (char)(32 + RgRng_Below(&rng, 95)), .color = RgRng_Below(&rng, 4) }
+				: (f == 1 ? bench->frames[0][i] : (RgSymbol){ .value = '.', .color = 1 });
+		}
+	}
+	bench->frame = 0;
+
+	bench->light = RgAllocArray(sizeof(*bench->light), cells);
+	for (RgSize i = 0; i < cells; ++i)
+		bench->light[i] = (RgPixel)RgRng_Next(&rng) & 0xFFFFFF;
+}
+
+static void Bench_DeInit(Bench *bench) {
+	bench->renderer.buffer = bench->frames[0];
+	RgRenderer_DeInit(&bench->renderer);
+	RgDeAlloc(bench->frames[1]);
+	RgDeAlloc(bench->light);
+	RgWindow_DeInit(&bench->window);
+}
+
+static int CompareDoubles(const void *a, const void *b) {
+	double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+static Result Measure(Bench *bench, BenchFunc *func, RgSize cells, RgSize pixels) {
+	// warm up, and size the batches from how fast the warmup went:
+	RgSize iters = 0;
+	uint64_t start = RgTimeNs();
+	while (RgTimeNs() - start < RG_BENCH_WARMUP_NS) {
+		func(bench);
+		++iters;
+	}
+	uint64_t perIter = (RgTimeNs() - start) / iters;
+	RgSize batch = Rg_Max((RgSize)(RG_BENCH_BATCH_NS / (perIter + 1)), (RgSize)1);
+
+	double samples[RG_BENCH_REPS];
+	for (int r = 0; r < RG_BENCH_REPS; ++r) {
+		start = RgTimeNs();
+		for (RgSize i = 0; i < batch; ++i) func(bench);
+		samples[r] = (double)(RgTimeNs() - start) / batch;
+	}
+
+	qsort(samples, RG_BENCH_REPS, sizeof(*samples), CompareDoubles);
+
+	Result result = {0};
+	result.nsPerIterMedian = samples[RG_BENCH_REPS / 2];
+	result.nsPerIterMin = samples[0];
+	result.nsPerCell = result.nsPerIterMedian / cells;
+	result.pixelsPerSec = pixels / (result.nsPerIterMedian / 1e9);
+	return result;
+}
+
+static bool Matches(const char *name, const char *filter) {
+	return filter == NULL || strstr(name, filter) != NULL;
+}
+
+static RgSize RunAll(Result *results, const char *filter) {
+	static const struct { RgSize w, h; } grids[] = { { 16, 16 }, { 80, 25 }, { 160, 50 } };
+	static const RgSize cellSizes[] = { 8, 10, 16 };
+	RgSize count = 0;
+
+	for (RgSize g = 0; g < sizeof(grids) / sizeof(*grids); ++g)
+	for (RgSize c = 0; c < sizeof(cellSizes) / sizeof(*cellSizes); ++c)
+	for (int d = DIRTY_CLEAR; d <= DIRTY_RANDOM; ++d) {
+		RgSize w = grids[g].w, h = grids[g].h, cell = cellSizes[c];
+		Bench bench;
+		Bench_Init(&bench, w, h, cell, d);
+		bench.renderer.drawBorder = false;
+
+		RgSize cells = w * h;
+		RgSize windowPixels = bench.window.bufferWidth * bench.window.bufferHeight;
+		RgSize borderPixels = 2 * (w * cell + 2) + 2 * h * cell;
+
+		struct { const char *op; BenchFunc *func; RgSize pixels; bool perDirty; } ops[] = {
+			{ "refresh", BenchRefresh, cells * 64, true }, // every cell blits an 8x8 glyph.
+			{ "refresh_lit", BenchRefreshLit, cells * 64, true },
+			{ "clear", BenchClear, cells, false },
+			{ "border", BenchBorder, borderPixels, false },
+			{ "window_refresh", BenchWindowRefresh, windowPixels, false },
+		};
+
+		for (RgSize o = 0; o < sizeof(ops) / sizeof(*ops); ++o) {
+			// only the glyph pass depends on buffer contents, and the fill doesn't depend on the cell size:
+			if (!ops[o].perDirty && d != DIRTY_CLEAR) continue;
+			if (ops[o].func == BenchClear && c != 0) continue;
+
+			char name[96];
+			if (ops[o].perDirty)
+				snprintf(name, sizeof(name), "%s/%zux%zu/cell%zu/%s", ops[o].op, w, h, cell, dirtyNames[d]);
+			else if (ops[o].func == BenchClear)
+				snprintf(name, sizeof(name), "%s/%zux%zu", ops[o].op, w, h);
+			else
+				snprintf(name, sizeof(name), "%s/%zux%zu/cell%zu", ops[o].op, w, h, cell);
+
+			if (!Matches(name, filter) || count == RG_BENCH_MAX_CASES) continue;
+
+			Result *result = &results[count++];
+			*result = Measure(&bench, ops[o].func, cells, ops[o].pixels);
+			snprintf(result->name, sizeof(result->name), "%s", name);
+
+			printf("%-36s %10.3f ns/cell %10.1f Mpx/s %12.0f ns (min %.0f)\n",
+				result->name, result->nsPerCell, result->pixelsPerSec / 1e6,
+				result->nsPerIterMedian, result->nsPerIterMin);
+			fflush(stdout);
+		}
+
+		Bench_DeInit(&bench);
+	}
+
+	return count;
+}
+
+static void WriteJson(const char *path, const Result *results, RgSize count) {
+	FILE *file = fopen(path, "w");
+	if (file == NULL) RgFail("Failed to open %s for writing.", path);
+
+	// one case per line, which is also what ReadBaseline expects:
+	fputs("{\n  \"unit\": \"ns_per_cell\",\n  \"cases\": [\n", file);
+	for (RgSize i = 0; i < count; ++i) {
+		fprintf(file,
+			"    {\"name\": \"%s\", \"ns_per_cell\": %.4f, \"pixels_per_s\": %.0f, \"ns_per_iter_median\": %.1f, \"ns_per_iter_min\": %.1f}%s\n",
+			results[i].name, results[i].nsPerCell, results[i].pixelsPerSec,
+			results[i].nsPerIterMedian, results[i].nsPerIterMin,
+			i + 1 < count ? "," : "");
+	}
+	fputs("  ]\n}\n", file);
+	fclose(file);
+}
+
+static RgSize ReadBaseline(const char *path, Result *baseline) {
+	FILE *file = fopen(path, "r");
+	if (file == NULL) RgFail("Failed to open baseline %s.", path);
+
+	RgSize count = 0;
+	char line[512];
+	while (count < RG_BENCH_MAX_CASES && fgets(line, sizeof(line), file) != NULL) {
+		const char *name = strstr(line, "\"name\": \"");
+		const char *value = strstr(line, "\"ns_per_cell\": ");
+		if (name == NULL || value == NULL) continue;
+
+		Result *result = &baseline[count];
+		if (sscanf(name + 9, "%95[^\"]", result->name) != 1) continue;
+		if (sscanf(value + 15, "%lf", &result->nsPerCell) != 1) continue;
+		++count;
+	}
+
+	fclose(file);
+	return count;
+}
+
+static int CompareBaseline(const Result *results, RgSize count, const char *path, double threshold) {
+	static Result baseline[RG_BENCH_MAX_CASES];
+	RgSize baselineCount = ReadBaseline(path, baseline);
+	int regressions = 0;
+
+	for (RgSize i = 0; i < count; ++i) {
+		const Result *base = NULL;
+		for (RgSize j = 0; j < baselineCount; ++j)
+			if (strcmp(baseline[j].name, results[i].name) == 0) base = &baseline[j];
+
+		if (base == NULL) {
+			printf("new      %-36s %10.3f ns/cell\n", results[i].name, results[i].nsPerCell);
+			continue;
+		}
+
+		double change = results[i].nsPerCell / base->nsPerCell - 1.0;
+		if (change > threshold) {
+			printf("REGRESSED %-35s %10.3f -> %.3f ns/cell (%+.1f%%)\n",
+				results[i].name, base->nsPerCell, results[i].nsPerCell, change * 100.0);
+			++regressions;
+		}
+	}
+
+	printf("%d regression(s) beyond %.0f%% of %s\n", regressions, threshold * 100.0, path);
+	return regressions > 0 ? 1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+	const char *jsonPath = NULL, *baselinePath = NULL, *filter = NULL;
+	double threshold = 0.10;
+
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+		else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) baselinePath = argv[++i];
+		else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) threshold = atof(argv[++i]);
+		else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+		else RgFail("Unknown argument: %s", argv[i]);
+	}
+
+	static Result results[RG_BENCH_MAX_CASES];
+	RgSize count = RunAll(results, filter);
+
+	if (jsonPath != NULL) WriteJson(jsonPath, results, count);
+	if (baselinePath != NULL) return CompareBaseline(results, count, baselinePath, threshold);
+	return 0;
+}
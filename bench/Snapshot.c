@@ -0,0 +1,79 @@
+/*
+ * measures snapshot save and load time against world size.
+ * usage: bench-snapshot [path] (defaults to ./snapshot-bench.rgs, removed afterwards)
+ */
+#include <Rogue/Core.h>
+#include <Rogue/World.h>
+#include <Rogue/Snapshot.h>
+#include <stdio.h>
+
+static void FillWorld(RgWorld *world, RgSize chunkCount) {
+	RgInt side = 1;
+	while ((RgSize)(side * side) < chunkCount) ++side;
+
+	for (RgSize i = 0; i < chunkCount; ++i) {
+		RgChunk *chunk = RgWorld_AddChunk(world, (int32_t)(i % side), (int32_t)(i / side));
+		for (RgSize t = 0; t < RG_CHUNK_AREA; ++t) {
+			uint64_t r = RgRng_Next(&world->rng);
+			chunk->tiles[t] = (RgTile){ .glyph = '.' + (r & 3), .color = (r >> 8) & 3, .flags = (r >> 16) & 3 };
+		}
+	}
+
+	for (RgSize i = 0; i < chunkCount * 4; ++i) {
+		RgEntity *entity = RgWorld_AddEntity(world);
+		entity->id = (uint32_t)i;
+		entity->x = RgRng_Below(&world->rng, side * RG_CHUNK_SIZE);
+		entity->y = RgRng_Below(&world->rng, side * RG_CHUNK_SIZE);
+		entity->glyph = 'g';
+	}
+}
+
+static double Ms(uint64_t ns) { return (double)ns / 1e6; }
+
+int main(int argc, char *argv[]) {
+	const char *path = argc > 1 ? argv[1] : "snapshot-bench.rgs";
+	static const RgSize sizesMb[] = { 1, 16, 64, 256, 512 };
+
+	printf("%8s %10s %10s %12s %12s %12s\n", "size", "chunks", "save ms", "save MB/s", "open ms", "verify ms");
+
+	for (RgSize s = 0; s < sizeof(sizesMb) / sizeof(*sizesMb); ++s) {
+		RgSize chunkCount = sizesMb[s] * 1024 * 1024 / sizeof(RgChunk);
+
+		RgWorld world;
+		RgWorld_Init(&world, 1234);
+		FillWorld(&world, chunkCount);
+
+		uint64_t start = RgTimeNs();
+		if (!RgSnapshot_Save(&world, path)) RgFail("Save failed.");
+		uint64_t saveNs = RgTimeNs() - start;
+
+		// open without verification, then touch one tile the way gameplay would:
+		RgSnapshot snapshot;
+		RgWorld loaded;
+		start = RgTimeNs();
+		if (!RgSnapshot_Open(&snapshot, path, false)) RgFail("Open failed.");
+		RgSnapshot_GetWorld(&snapshot, &loaded);
+		volatile uint8_t sink = loaded.chunks[loaded.chunkCount / 2].tiles[7].glyph;
+		uint64_t openNs = RgTimeNs() - start;
+		(void)sink;
+
+		if (loaded.chunkCount != world.chunkCount || loaded.entityCount != world.entityCount)
+			RgFail("Loaded world does not match the saved one.");
+
+		RgWorld_DeInit(&loaded);
+		RgSnapshot_Close(&snapshot);
+
+		start = RgTimeNs();
+		if (!RgSnapshot_Open(&snapshot, path, true)) RgFail("Verified open failed.");
+		uint64_t verifyNs = RgTimeNs() - start;
+		RgSnapshot_Close(&snapshot);
+
+		double mb = (double)(sizeof(RgChunk) * world.chunkCount + sizeof(RgEntity) * world.entityCount) / (1024.0 * 1024.0);
+		printf("%6zuMB %10zu %10.2f %12.0f %12.3f %12.2f\n",
+			sizesMb[s], world.chunkCount, Ms(saveNs), mb / (saveNs / 1e9), Ms(openNs), Ms(verifyNs));
+
+		RgWorld_DeInit(&world);
+	}
+
+	remove(path);
+}
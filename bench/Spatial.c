@@ -0,0 +1,79 @@
+/*
+ * measures the spatial grid's move, point, radius and nearest queries for growing numbers of
+ * entities spread over a 512x512 tile area, against a linear scan for the radius query.
+ */
+#include <Rogue/Core.h>
+#include <Rogue/Spatial.h>
+#include <Rogue/Random.h>
+#include <stdio.h>
+
+#define AREA 512
+#define QUERIES 100000
+#define QUERY_RADIUS 8
+
+static bool CountNode(void *data, [[maybe_unused]] RgSpatialNode *node) {
+	++*(RgSize *)data;
+	return true;
+}
+
+static inline int32_t RandomCoord(RgRng *rng) {
+	return (int32_t)RgRng_Below(rng, AREA) - AREA / 2;
+}
+
+int main(void) {
+	static const RgSize counts[] = { 1000, 10000, 100000 };
+
+	printf("%10s %10s %10s %10s %10s %12s\n", "entities", "move ns", "point ns", "radius ns", "nearest ns", "scan ns");
+
+	for (RgSize c = 0; c < sizeof(counts) / sizeof(*counts); ++c) {
+		RgRng rng;
+		RgRng_Init(&rng, 7);
+
+		RgSpatialNode *nodes = RgAllocArray(sizeof(*nodes), counts[c]);
+		RgSpatialGrid grid;
+		RgSpatialGrid_Init(&grid);
+		for (RgSize i = 0; i < counts[c]; ++i)
+			RgSpatialGrid_Insert(&grid, &nodes[i], RandomCoord(&rng), RandomCoord(&rng));
+
+		uint64_t start = RgTimeNs();
+		for (RgSize q = 0; q < QUERIES; ++q) {
+			RgSpatialNode *node = &nodes[RgRng_Below(&rng, (uint32_t)counts[c])];
+			RgSpatialGrid_Move(&grid, node, node->x + (int32_t)RgRng_Below(&rng, 3) - 1, node->y + (int32_t)RgRng_Below(&rng, 3) - 1);
+		}
+		double moveNs = (double)(RgTimeNs() - start) / QUERIES;
+
+		RgSize hits = 0;
+		start = RgTimeNs();
+		for (RgSize q = 0; q < QUERIES; ++q)
+			hits += RgSpatialGrid_IsOccupied(&grid, RandomCoord(&rng), RandomCoord(&rng));
+		double pointNs = (double)(RgTimeNs() - start) / QUERIES;
+
+		start = RgTimeNs();
+		for (RgSize q = 0; q < QUERIES; ++q)
+			RgSpatialGrid_QueryRadius(&grid, RandomCoord(&rng), RandomCoord(&rng), QUERY_RADIUS, &CountNode, &hits);
+		double radiusNs = (double)(RgTimeNs() - start) / QUERIES;
+
+		start = RgTimeNs();
+		for (RgSize q = 0; q < QUERIES; ++q)
+			hits += RgSpatialGrid_Nearest(&grid, RandomCoord(&rng), RandomCoord(&rng), AREA, NULL, NULL) != NULL;
+		double nearestNs = (double)(RgTimeNs() - start) / QUERIES;
+
+		// the same radius query as a scan over every entity, on fewer queries:
+		RgSize scanQueries = QUERIES / 100;
+		start = RgTimeNs();
+		for (RgSize q = 0; q < scanQueries; ++q) {
+			int64_t x = RandomCoord(&rng), y = RandomCoord(&rng);
+			for (RgSize i = 0; i < counts[c]; ++i) {
+				int64_t dx = nodes[i].x - x, dy = nodes[i].y - y;
+				hits += dx * dx + dy * dy <= QUERY_RADIUS * QUERY_RADIUS;
+			}
+		}
+		double scanNs = (double)(RgTimeNs() - start) / scanQueries;
+
+		printf("%10zu %10.1f %10.1f %10.1f %10.1f %12.1f\n", counts[c], moveNs, pointNs, radiusNs, nearestNs, scanNs);
+		if (hits == 0) printf("no hits\n"); // keeps the queries from being optimized out.
+
+		RgSpatialGrid_DeInit(&grid);
+		RgDeAlloc(nodes);
+	}
+}
@@ -0,0 +1,60 @@
+/*
+ * measures how long the turn scheduler takes to advance one normal-speed turn
+ * (RG_TURN_ACTION_COST / RG_TURN_NORMAL_SPEED ticks) for growing numbers of actors.
+ */
+#include <Rogue/Core.h>
+#include <Rogue/Turn.h>
+#include <Rogue/Random.h>
+#include <stdio.h>
+
+typedef struct {
+	RgTurnActor turn;
+	uint32_t actions;
+} Monster;
+
+int main(void) {
+	static const RgSize counts[] = { 1000, 10000, 100000, 1000000 };
+	const RgSize turns = 100;
+
+	printf("%10s %12s %14s %12s\n", "actors", "ms/turn", "ns/action", "batches/turn");
+
+	for (RgSize c = 0; c < sizeof(counts) / sizeof(*counts); ++c) {
+		RgRng rng;
+		RgRng_Init(&rng, 99);
+
+		Monster *monsters = RgAllocArray(sizeof(*monsters), counts[c]);
+		RgTurnScheduler scheduler;
+		RgTurnScheduler_Init(&scheduler);
+
+		// speeds from half to double normal speed, with staggered starting energy:
+		for (RgSize i = 0; i < counts[c]; ++i) {
+			uint32_t speed = RG_TURN_NORMAL_SPEED / 2 + RgRng_Below(&rng, RG_TURN_NORMAL_SPEED * 3 / 2 + 1);
+			RgTurnScheduler_Add(&scheduler, &monsters[i].turn, speed, (int32_t)RgRng_Below(&rng, RG_TURN_ACTION_COST));
+		}
+
+		uint64_t ticks = turns * RG_TURN_ACTION_COST / RG_TURN_NORMAL_SPEED;
+		uint64_t end = scheduler.now + ticks;
+		RgSize actions = 0, batches = 0;
+
+		uint64_t start = RgTimeNs();
+		while (scheduler.now < end) {
+			RgTurnActor **batch;
+			RgSize count = RgTurnScheduler_NextBatch(&scheduler, &batch);
+			for (RgSize i = 0; i < count; ++i) {
+				Monster *monster = (Monster *)batch[i];
+				++monster->actions;
+				// mostly normal actions, sometimes a slow or a quick one:
+				batch[i]->cost = RG_TURN_ACTION_COST / 2 + RgRng_Below(&rng, RG_TURN_ACTION_COST + 1);
+			}
+			actions += count;
+			++batches;
+		}
+		uint64_t elapsed = RgTimeNs() - start;
+
+		printf("%10zu %12.3f %14.1f %12.1f\n",
+			counts[c], elapsed / 1e6 / turns, (double)elapsed / actions, (double)batches / turns);
+
+		RgTurnScheduler_DeInit(&scheduler);
+		RgDeAlloc(monsters);
+	}
+}
@@ -0,0 +1,57 @@
+#ifndef RG_ASSET_H_
+#define RG_ASSET_H_
+#include <Rogue/Core.h>
+#include <Rogue/Renderer.h>
+#include <Rogue/Job.h>
+
+/*
+ * font and palette files, read through a read-only mapping. PSF1, PSF2 and BDF glyphs are all
+ * expanded once into the renderer's row words, so drawing never looks at the file's bit layout.
+ * RgAssetLoad runs the loading on the job system, so it can overlap window creation or run
+ * during play.
+ */
+
+typedef struct {
+	RgFont font; /* cell size defaults to the glyph size. */
+	uint64_t *rows; /* expanded glyphs behind font.symbolRows. */
+	RgSize *asciiMap; /* 256 glyph indices behind font.fontAsciiMap, or NULL. */
+} RgFontFile;
+
+/* loads a PSF1, PSF2 or BDF font, picked by the file's contents. logs and returns false on failure. */
+[[nodiscard]] bool RgFontFile_Load(RgFontFile *self, const char *path);
+void RgFontFile_DeInit(RgFontFile *self);
+
+/*
+ * a palette file holds one color per line, either as hex `#RRGGBB` / `RRGGBB` or as a GIMP
+ * palette line of three decimal components. blank lines, `;` comments and GIMP header lines are
+ * skipped. colors are stored in RgPixel channel order.
+ */
+typedef struct {
+	RgPixel *colors;
+	RgSize count;
+} RgPalette;
+
+[[nodiscard]] bool RgPalette_Load(RgPalette *self, const char *path);
+void RgPalette_DeInit(RgPalette *self);
+
+/* a font and/or palette being loaded on the job system. once the load is done, the caller may
+   take the loaded assets, clearing their flag so RgAssetLoad_DeInit leaves them alone. */
+typedef struct {
+	RgJobSystem *jobs;
+	char *fontPath, *palettePath; /* copies, or NULL for assets not requested. */
+	RgFontFile font;
+	RgPalette palette;
+	bool fontLoaded, paletteLoaded; /* valid once the load is done. */
+	RgJobCounter pending;
+} RgAssetLoad;
+
+/* starts loading the given files. either path may be NULL. */
+void RgAssetLoad_Start(RgAssetLoad *self, RgJobSystem *jobs, const char *fontPath, const char *palettePath);
+/* whether the load finished. never blocks, but runs a job itself when there are no other workers. */
+[[nodiscard]] bool RgAssetLoad_IsDone(RgAssetLoad *self);
+/* helps with the load until it is done. */
+void RgAssetLoad_Wait(RgAssetLoad *self);
+/* waits for the load and frees the paths and any assets that weren't taken. */
+void RgAssetLoad_DeInit(RgAssetLoad *self);
+
+#endif // RG_ASSET_H_
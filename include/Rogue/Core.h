@@ -5,8 +5,10 @@
 
 [[gnu::format(printf, 1, 2)]] [[noreturn]] void RgFail(const char *fmt, ...);
 [[gnu::format(printf, 1, 2)]] void RgLogError(const char *fmt, ...);
+[[gnu::format(printf, 1, 2)]] void RgLogInfo(const char *fmt, ...);
 [[gnu::malloc]] void *RgAlloc(size_t size);
 [[gnu::alloc_size(1, 2)]] void *RgAllocArray(size_t elemSize, size_t numElems);
+[[gnu::malloc]] void *RgAllocAligned(size_t alignment, size_t size); /* size is rounded up to alignment. */
 void RgDeAlloc(void *ptr);
 
 static inline void RgMemFill(uint8_t byte, void *start, size_t size) {
@@ -28,5 +30,10 @@ static inline RgSize RgSize_Max(RgSize a, RgSize b) { return a < b ? b : a; }
 #define Rg_Min(A, B) _Generic((A), RgInt: RgInt_Min, RgSize: RgSize_Min)((A), (B))
 #define Rg_Max(A, B) _Generic((A), RgInt: RgInt_Max, RgSize: RgSize_Max)((A), (B))
 
+/* monotonic time in nanoseconds. only differences between calls are meaningful. */
+[[nodiscard]] uint64_t RgTimeNs(void);
+
+/* fast non-cryptographic 64-bit hash (XXH64) of `size` bytes at `data`. */
+[[nodiscard]] uint64_t RgHash(const void *data, RgSize size, uint64_t seed);
 
 #endif // RG_CORE_H_
@@ -0,0 +1,59 @@
+#ifndef RG_JOB_H_
+#define RG_JOB_H_
+#include <Rogue/Core.h>
+#include <stdatomic.h>
+
+/*
+ * work-stealing job scheduler. every worker thread owns a deque: it pushes and pops jobs at
+ * one end, idle workers steal from the other. the thread that calls RgJobSystem_Init is
+ * worker 0 (the main thread) and also owns a pinned queue for work that has to run on it,
+ * such as GL calls.
+ */
+
+typedef void RgJobFunc(void *data);
+typedef void RgJobRangeFunc(void *data, RgSize begin, RgSize end);
+
+/* number of unfinished jobs spawned against it. zero-initialize, spawn, then wait on it.
+   a job may spawn children against its own counter to fork-join recursively. */
+typedef struct {
+	atomic_size_t pending;
+} RgJobCounter;
+
+typedef struct {
+	RgSize workerCount; /* worker threads including the main thread. 0 means one per hardware thread. */
+} RgJobSystemInitInfo;
+
+typedef struct {
+	RgSize workerCount; /* worker threads including the main thread. */
+	struct RgJobSystemImpl *impl_;
+} RgJobSystem;
+
+void RgJobSystem_Init(RgJobSystem *self, const RgJobSystemInitInfo *info);
+/* runs every job still queued, including main-thread ones, then stops the workers. call it on
+   the main thread once nothing else spawns into the system. */
+void RgJobSystem_DeInit(RgJobSystem *self);
+
+/* queues `func(data)` on any worker. `counter` may be NULL for fire-and-forget jobs. */
+void RgJobSystem_Spawn(RgJobSystem *self, RgJobFunc *func, void *data, RgJobCounter *counter);
+
+/* queues `func(data)` to run on the main thread, in RgJobSystem_RunMain or while it waits. */
+void RgJobSystem_SpawnMain(RgJobSystem *self, RgJobFunc *func, void *data, RgJobCounter *counter);
+
+/* runs other jobs until every job spawned against `counter` has finished. */
+void RgJobSystem_Wait(RgJobSystem *self, RgJobCounter *counter);
+
+/* runs the jobs queued with RgJobSystem_SpawnMain. main thread only. returns how many ran. */
+RgSize RgJobSystem_RunMain(RgJobSystem *self);
+
+/* runs at most one queued job on the calling worker. lets a polling main thread make progress
+   when it is the only worker. returns whether a job ran. */
+bool RgJobSystem_RunOne(RgJobSystem *self);
+
+/* calls `func(data, b, e)` over disjoint sub-ranges covering [begin, end) and waits for all of
+   them. a `grain` of 0 picks the sub-range size from the range length and worker count. */
+void RgJobSystem_ParallelFor(RgJobSystem *self, RgSize begin, RgSize end, RgSize grain, RgJobRangeFunc *func, void *data);
+
+/* index of the calling worker in [0, workerCount), or SIZE_MAX on a thread the system doesn't own. */
+[[nodiscard]] RgSize RgJobSystem_WorkerIndex(RgJobSystem *self);
+
+#endif // RG_JOB_H_
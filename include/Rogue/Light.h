@@ -0,0 +1,73 @@
+#ifndef RG_LIGHT_H_
+#define RG_LIGHT_H_
+#include <Rogue/Core.h>
+#include <Rogue/Window.h>
+#include <Rogue/World.h>
+
+/*
+ * colored point lights over a window of world tiles. every light remembers the intensities it
+ * last added, so moving a light or changing a wall only subtracts that light's old contribution
+ * and adds its new one; nothing else is recomputed. visibility from each light uses recursive
+ * shadowcasting against the map's own opacity grid.
+ */
+
+#define RG_LIGHT_MAX_RADIUS 15
+#define RG_LIGHT_AREA_ ((2 * RG_LIGHT_MAX_RADIUS + 1) * (2 * RG_LIGHT_MAX_RADIUS + 1))
+
+/* embed or allocate in the game's objects. x, y, radius and color are the user's; after changing
+   them, call RgLightMap_Invalidate. everything else is owned by the light map. */
+typedef struct {
+	int32_t x, y; /* position in tiles. */
+	uint8_t radius; /* at most RG_LIGHT_MAX_RADIUS. */
+	RgPixel color; /* at the source, in RgPixel channel order (0xBBGGRR). */
+
+	int32_t litX, litY; /* position the cached contribution was computed at. */
+	uint8_t litRadius;
+	RgPixel litColor;
+	bool lit, dirty;
+	RgSize index; /* in the light map's light list. */
+	uint8_t *intensity; /* RG_LIGHT_AREA_ intensities around (litX, litY), row-major. */
+} RgLight;
+
+typedef struct {
+	int32_t originX, originY; /* tile at the window's top-left corner. */
+	RgSize width, height; /* window size in tiles. */
+	RgPixel ambient; /* added to every tile. */
+	uint8_t *opaque; /* 1 per tile that blocks light. tiles outside the window block light too. */
+	uint32_t *accum; /* per tile, a sum over all lights for each of the 3 channels, plus padding. wide enough for every light to overlap. */
+	RgPixel *packed; /* ambient + accum, saturated per channel. */
+	RgLight **lights;
+	RgSize lightCount, lightCapacity;
+} RgLightMap;
+
+void RgLightMap_Init(RgLightMap *self, RgSize width, RgSize height, RgPixel ambient);
+void RgLightMap_DeInit(RgLightMap *self);
+
+/* moves the window and reloads its opacity from `world`. relights everything. */
+void RgLightMap_SetOrigin(RgLightMap *self, int32_t x, int32_t y, RgWorld *world);
+
+void RgLightMap_Add(RgLightMap *self, RgLight *light);
+void RgLightMap_Remove(RgLightMap *self, RgLight *light);
+/* marks `light`, which must have been added to `self`, for recomputation after its fields changed. */
+void RgLightMap_Invalidate(RgLightMap *self, RgLight *light);
+static inline void RgLightMap_Move(RgLightMap *self, RgLight *light, int32_t x, int32_t y) {
+	if (light->x == x && light->y == y) return;
+	light->x = x;
+	light->y = y;
+	RgLightMap_Invalidate(self, light);
+}
+
+/* changes the opacity of one tile, marking only the lights that reached it. */
+void RgLightMap_SetOpaque(RgLightMap *self, int32_t x, int32_t y, bool opaque);
+/* compares the window against `world`'s opaque flags and applies the tiles that differ.
+   unloaded chunks count as transparent. */
+void RgLightMap_SyncOpacity(RgLightMap *self, RgWorld *world);
+
+/* relights every light marked since the last update. returns how many were relit. */
+RgSize RgLightMap_Update(RgLightMap *self);
+
+/* copies the packed light of a width x height rectangle of tiles into `out`. tiles outside the
+   window get the ambient light. */
+void RgLightMap_Read(const RgLightMap *self, int32_t x, int32_t y, RgSize width, RgSize height, RgPixel *out);
+
+#endif // RG_LIGHT_H_
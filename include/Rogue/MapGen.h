@@ -0,0 +1,59 @@
+#ifndef RG_MAPGEN_H_
+#define RG_MAPGEN_H_
+#include <Rogue/Core.h>
+#include <Rogue/World.h>
+#include <Rogue/Job.h>
+#include <threads.h>
+
+/*
+ * procedural map generation. every chunk is a pure function of the seed and its coordinates:
+ * all randomness comes from counter-based streams keyed on (seed, position, stage), so chunks
+ * come out byte-identical no matter which thread generates them or in what order.
+ *
+ * the base layer is fixed-point value noise terrain. a coarser noise then picks a region type
+ * per chunk: cellular-automata caves, BSP rooms, or open terrain.
+ */
+
+typedef enum : uint8_t {
+	RG_MAPGEN_REGION_TERRAIN = 0,
+	RG_MAPGEN_REGION_CAVES = 1,
+	RG_MAPGEN_REGION_ROOMS = 2,
+} RgMapGenRegion;
+
+[[nodiscard]] RgMapGenRegion RgMapGen_GetRegion(uint64_t seed, int32_t x, int32_t y);
+
+/* fills `chunk` with the chunk at chunk coordinates (x, y). thread-safe. */
+void RgMapGen_GenerateChunk(uint64_t seed, int32_t x, int32_t y, RgChunk *chunk);
+
+/* generates requested chunks on the job system and hands finished ones to the main thread. */
+typedef struct {
+	RgJobSystem *jobs;
+	uint64_t seed;
+	uint64_t *requested; /* open-addressed set of requested packed chunk coordinates. */
+	RgSize requestedCapacity, requestedCount;
+	RgJobCounter pending; /* chunks still being generated. */
+	mtx_t lock; /* guards `done`. */
+	struct RgMapGenTask_ **done; /* finished chunks waiting for RgMapStreamer_Drain. */
+	RgSize doneCount, doneCapacity;
+} RgMapStreamer;
+
+void RgMapStreamer_Init(RgMapStreamer *self, RgJobSystem *jobs, uint64_t seed);
+/* waits for chunks still being generated and drops everything not yet drained. */
+void RgMapStreamer_DeInit(RgMapStreamer *self);
+
+/* queues generation of chunk (x, y) unless it was requested before. never blocks. */
+void RgMapStreamer_Request(RgMapStreamer *self, int32_t x, int32_t y);
+
+/* queues every chunk within `radius` chunks of chunk (x, y), nearest first. */
+void RgMapStreamer_RequestAround(RgMapStreamer *self, int32_t x, int32_t y, int32_t radius);
+
+/* adds up to `maxChunks` finished chunks to `world`, without waiting. returns how many. */
+RgSize RgMapStreamer_Drain(RgMapStreamer *self, RgWorld *world, RgSize maxChunks);
+
+/* whether requested chunks are still being generated or waiting to be drained. */
+[[nodiscard]] bool RgMapStreamer_IsBusy(RgMapStreamer *self);
+
+/* waits for every requested chunk and adds them all to `world`. */
+void RgMapStreamer_Flush(RgMapStreamer *self, RgWorld *world);
+
+#endif // RG_MAPGEN_H_
@@ -0,0 +1,79 @@
+#ifndef RG_RANDOM_H_
+#define RG_RANDOM_H_
+#include <Rogue/Core.h>
+
+/* xoshiro256** generator state. plain data, so it can be saved and restored as-is. */
+typedef struct {
+	uint64_t state[4];
+} RgRng;
+
+static inline uint64_t RgRng_Rotl_(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+static inline uint64_t RgRng_SplitMix_(uint64_t *x) {
+	uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+static inline void RgRng_Init(RgRng *self, uint64_t seed) {
+	for (int i = 0; i < 4; ++i)
+		self->state[i] = RgRng_SplitMix_(&seed);
+}
+
+static inline uint64_t RgRng_Next(RgRng *self) {
+	uint64_t *s = self->state;
+	uint64_t result = RgRng_Rotl_(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = RgRng_Rotl_(s[3], 45);
+	return result;
+}
+
+/* uniform integer in [0, bound). bound must be non-zero. */
+static inline uint32_t RgRng_Below(RgRng *self, uint32_t bound) {
+	return (uint32_t)(((RgRng_Next(self) >> 32) * bound) >> 32);
+}
+
+/* splitmix64 finalizer: a bijective 64-bit mix. */
+static inline uint64_t RgRandom_Mix(uint64_t z) {
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+/* counter-based random value: a pure function of `key` and `counter`, so any element of a
+   stream can be computed directly, by any thread, in any order. */
+static inline uint64_t RgRandom_Hash(uint64_t key, uint64_t counter) {
+	return RgRandom_Mix(key ^ RgRandom_Mix(counter + 0x9E3779B97F4A7C15ull));
+}
+
+/* derives a stream key from a seed, a 2D coordinate and a stream id (e.g. one per generator stage). */
+static inline uint64_t RgRandom_Key(uint64_t seed, int64_t x, int64_t y, uint64_t stream) {
+	return RgRandom_Hash(RgRandom_Hash(RgRandom_Hash(seed, stream), (uint64_t)x), (uint64_t)y);
+}
+
+/* sequential view of a counter-based stream. */
+typedef struct {
+	uint64_t key, counter;
+} RgCounterRng;
+
+static inline void RgCounterRng_Init(RgCounterRng *self, uint64_t key) {
+	self->key = key;
+	self->counter = 0;
+}
+
+static inline uint64_t RgCounterRng_Next(RgCounterRng *self) {
+	return RgRandom_Hash(self->key, self->counter++);
+}
+
+/* uniform integer in [0, bound). bound must be non-zero. */
+static inline uint32_t RgCounterRng_Below(RgCounterRng *self, uint32_t bound) {
+	return (uint32_t)(((RgCounterRng_Next(self) >> 32) * bound) >> 32);
+}
+
+#endif // RG_RANDOM_H_
@@ -4,12 +4,16 @@
 #include <Rogue/Core.h>
 
 typedef struct {
-	RgSize symbolWidth, symbolHeight;
-	RgSize *fontAsciiMap;
-	RgSize symbolCount;
-	const uint8_t *symbolBitmaps;
+	RgSize symbolWidth, symbolHeight; /* cell size in pixels. glyphs are centered in their cell. */
+	RgSize *fontAsciiMap; /* glyph index for each of the 256 symbol values, or NULL to use the value itself. */
+	RgSize symbolCount; /* glyphs in symbolRows. symbols mapped past the end are drawn blank. */
+	const uint64_t *symbolRows; /* glyphHeight rows per glyph, one word each with the leftmost pixel in bit 0. */
+	RgSize glyphWidth, glyphHeight; /* glyph size in pixels. at most 64 wide. */
 } RgFont;
 
+/* fills `self` with the built-in 8x8 font, centered in cells of the given size. */
+void RgFont_InitBuiltin(RgFont *self, RgSize cellWidth, RgSize cellHeight);
+
 typedef struct [[gnu::packed]] {
 	char value;
 	uint8_t color;
@@ -21,6 +25,8 @@ typedef struct {
 	RgSymbol *buffer; /* symbol buffer. owned by the renderer. */
 	RgFont *font; /* font to render with. owned by the user. */
 	RgPixel *palette; /* palette that symbol colors refer to. owned by the user. TODO */
+	const RgPixel *light; /* per-symbol color its palette color is multiplied by, or NULL for none. owned by the user. */
+	RgPixel *colors; /* lit color per symbol, rebuilt every refresh. owned by the renderer. */
 	struct { RgInt x, y; } screenOffset; /* offset of the screen. */
 	RgPixel borderColor; /* color of the border around the screen. */
 	RgBool drawBorder; /* whether to draw a border around the screen. */
@@ -28,6 +34,10 @@ typedef struct {
 
 void RgRenderer_Init(RgRenderer *self, RgWindow *window, size_t width, size_t height, RgFont *font);
 void RgRenderer_Refresh(RgRenderer *self);
+/* fills the whole symbol buffer with one symbol. */
+void RgRenderer_Clear(RgRenderer *self, char value, uint8_t color);
+/* draws the border around the screen, regardless of drawBorder. RgRenderer_Refresh calls this. */
+void RgRenderer_DrawBorder(RgRenderer *self);
 void RgRenderer_DeInit(RgRenderer *self);
 
 #endif // RG_RENDERER_H_
@@ -0,0 +1,65 @@
+#ifndef RG_SNAPSHOT_H_
+#define RG_SNAPSHOT_H_
+#include <Rogue/Core.h>
+#include <Rogue/World.h>
+
+/*
+ * binary world snapshot. the file is little-endian and offset-based: the header is followed by
+ * the raw chunk and entity arrays, each aligned to RG_SNAPSHOT_ALIGN, so a mapped snapshot is
+ * used in place with no deserialization step.
+ */
+
+#define RG_SNAPSHOT_MAGIC 0x000050414E534752ull /* "RGSNAP\0\0" */
+#define RG_SNAPSHOT_VERSION 1
+#define RG_SNAPSHOT_ALIGN 64
+
+typedef struct {
+	uint64_t offset, size; /* byte range of the section in the file. */
+	uint64_t count; /* number of records in the section. */
+	uint64_t checksum; /* RgHash of the section bytes. */
+} RgSnapshotSection;
+
+typedef struct {
+	uint64_t magic; /* RG_SNAPSHOT_MAGIC. */
+	uint32_t version; /* RG_SNAPSHOT_VERSION. */
+	uint32_t headerSize; /* sizeof(RgSnapshotHeader). */
+	uint64_t fileSize; /* total size of the file in bytes. */
+	uint32_t chunkSize; /* RG_CHUNK_SIZE. */
+	uint32_t chunkRecordSize; /* sizeof(RgChunk). */
+	uint32_t entityRecordSize; /* sizeof(RgEntity). */
+	uint32_t reserved;
+	RgRng rng;
+	RgSnapshotSection chunks, entities;
+	uint64_t headerChecksum; /* RgHash of every header byte before this field. */
+} RgSnapshotHeader;
+
+static_assert(sizeof(RgSnapshotHeader) == 144, "RgSnapshotHeader layout is part of the snapshot format");
+
+typedef struct {
+	void *data; /* private copy-on-write mapping of the file. */
+	RgSize size; /* size of the mapping in bytes. */
+	const RgSnapshotHeader *header;
+} RgSnapshot;
+
+/* writes `world` to `path` with a single gathered write, replacing the file atomically. returns
+   once the new file is on disk, so a crash or power loss keeps either the old or the new save. */
+[[nodiscard]] bool RgSnapshot_Save(const RgWorld *world, const char *path);
+
+/* forks and saves from the child, so the caller can keep mutating the world while the
+   copy-on-write child writes. returns the child's pid, or -1 on failure. */
+[[nodiscard]] int RgSnapshot_SaveForked(const RgWorld *world, const char *path);
+
+/* waits for a save started by RgSnapshot_SaveForked. returns whether it succeeded. */
+[[nodiscard]] bool RgSnapshot_WaitForked(int pid);
+
+/* maps `path` and validates the header. with `verify`, the section checksums are checked as
+   well, which reads the whole file. */
+[[nodiscard]] bool RgSnapshot_Open(RgSnapshot *self, const char *path, bool verify);
+
+/* points `world` at the mapped arrays. the world borrows them, so it must be de-initialized
+   before the snapshot is closed. writes only touch private pages, never the file. */
+void RgSnapshot_GetWorld(RgSnapshot *self, RgWorld *world);
+
+void RgSnapshot_Close(RgSnapshot *self);
+
+#endif // RG_SNAPSHOT_H_
@@ -0,0 +1,55 @@
+#ifndef RG_SPATIAL_H_
+#define RG_SPATIAL_H_
+#include <Rogue/Core.h>
+#include <Rogue/World.h>
+
+/*
+ * spatial index keyed by tile coordinates. tiles are grouped in blocks that line up with world
+ * chunks; each block has an intrusive list head per tile and an occupancy bit per tile, one
+ * 32-bit word per row, so area queries skip empty tiles a row at a time. blocks are created on
+ * first insert and kept until RgSpatialGrid_DeInit.
+ */
+
+/* embed in the game's objects. every field is owned by the grid. */
+typedef struct RgSpatialNode {
+	struct RgSpatialNode *next, *prev; /* other nodes on the same tile. */
+	struct RgSpatialBlock_ *block; /* NULL while not in a grid. */
+	int32_t x, y; /* tile the node is filed under. */
+} RgSpatialNode;
+
+/* called for every node a query finds. return false to stop the query. nodes must not be
+   inserted, moved or removed from inside the callback. */
+typedef bool RgSpatialVisitFunc(void *data, RgSpatialNode *node);
+/* decides whether a node may be returned by RgSpatialGrid_Nearest. */
+typedef bool RgSpatialFilterFunc(void *data, const RgSpatialNode *node);
+
+typedef struct {
+	struct RgSpatialBlock_ **blocks; /* open-addressed by block coordinates, NULL when empty. */
+	RgSize blockCapacity, blockCount;
+	struct RgSpatialBlock_ *lastBlock; /* most recently used block, checked before the table. */
+	struct { int32_t x0, y0, x1, y1; } blockBounds; /* in blocks, around every block in the table. */
+	RgSize nodeCount;
+} RgSpatialGrid;
+
+void RgSpatialGrid_Init(RgSpatialGrid *self);
+void RgSpatialGrid_DeInit(RgSpatialGrid *self);
+
+void RgSpatialGrid_Insert(RgSpatialGrid *self, RgSpatialNode *node, int32_t x, int32_t y);
+void RgSpatialGrid_Remove(RgSpatialGrid *self, RgSpatialNode *node);
+void RgSpatialGrid_Move(RgSpatialGrid *self, RgSpatialNode *node, int32_t x, int32_t y);
+
+/* first node on tile (x, y), or NULL. the rest follow through `next`. */
+[[nodiscard]] RgSpatialNode *RgSpatialGrid_At(RgSpatialGrid *self, int32_t x, int32_t y);
+[[nodiscard]] bool RgSpatialGrid_IsOccupied(RgSpatialGrid *self, int32_t x, int32_t y);
+
+/* visits the nodes on tiles in [x0, x1] x [y0, y1]. returns how many were visited. */
+RgSize RgSpatialGrid_QueryRect(RgSpatialGrid *self, int32_t x0, int32_t y0, int32_t x1, int32_t y1, RgSpatialVisitFunc *func, void *data);
+
+/* visits the nodes within euclidean distance `radius` of (x, y). returns how many were visited. */
+RgSize RgSpatialGrid_QueryRadius(RgSpatialGrid *self, int32_t x, int32_t y, int32_t radius, RgSpatialVisitFunc *func, void *data);
+
+/* nearest node to (x, y) by euclidean distance within `maxRadius` that passes `filter` (which may
+   be NULL), or NULL. ties go to the first node found. */
+[[nodiscard]] RgSpatialNode *RgSpatialGrid_Nearest(RgSpatialGrid *self, int32_t x, int32_t y, int32_t maxRadius, RgSpatialFilterFunc *filter, void *data);
+
+#endif // RG_SPATIAL_H_
@@ -0,0 +1,71 @@
+#ifndef RG_TURN_H_
+#define RG_TURN_H_
+#include <Rogue/Core.h>
+
+/*
+ * energy-based turn scheduler. actors gain `speed` energy per tick and act once they have
+ * RG_TURN_ACTION_COST. instead of topping every actor up every tick, each actor is filed
+ * under the tick it will next act on in a hierarchical timing wheel, so scheduling and
+ * cancelling are O(1) and only ticks where someone acts are visited.
+ */
+
+#define RG_TURN_ACTION_COST 100 /* energy needed to act, and the cost of a normal action. */
+#define RG_TURN_NORMAL_SPEED 10 /* energy per tick of a normal-speed actor: one action per 10 ticks. */
+
+#define RG_TURN_WHEEL_BITS 6
+#define RG_TURN_WHEEL_SLOTS (1 << RG_TURN_WHEEL_BITS)
+#define RG_TURN_WHEEL_LEVELS 4 /* ticks further out than 2^24 go to an overflow list. */
+
+typedef enum : uint8_t {
+	RG_TURN_ACTOR_IDLE = 0, /* not in the scheduler. */
+	RG_TURN_ACTOR_WAITING = 1, /* filed in the wheel. */
+	RG_TURN_ACTOR_READY = 2, /* in the current batch. */
+} RgTurnActorState;
+
+/* embed in the game's actor. every field is owned by the scheduler except `cost`. */
+typedef struct RgTurnActor {
+	struct RgTurnActor *next, *prev; /* intrusive list of the wheel slot. */
+	uint64_t due; /* tick the actor acts on next. */
+	uint64_t energyTick; /* tick `energy` was last brought up to date. */
+	int32_t energy;
+	uint32_t speed; /* energy gained per tick. */
+	uint32_t cost; /* energy the action taken in this batch costs. defaults to RG_TURN_ACTION_COST. */
+	RgSize batchIndex; /* position in the current batch while ready. */
+	RgTurnActorState state;
+	uint8_t level, slot; /* where the actor is filed while waiting. */
+} RgTurnActor;
+
+typedef struct {
+	uint64_t now; /* current tick. */
+	RgTurnActor *slots[RG_TURN_WHEEL_LEVELS][RG_TURN_WHEEL_SLOTS];
+	uint64_t occupied[RG_TURN_WHEEL_LEVELS]; /* bit per non-empty slot. */
+	RgTurnActor *overflow;
+	RgTurnActor **batch; /* actors acting on `now`. owned by the scheduler. */
+	RgSize batchCount, batchCapacity;
+	RgSize actorCount; /* waiting and ready actors. */
+} RgTurnScheduler;
+
+void RgTurnScheduler_Init(RgTurnScheduler *self);
+void RgTurnScheduler_DeInit(RgTurnScheduler *self);
+
+/* starts scheduling `actor` with the given speed (must be non-zero) and starting energy.
+   the actor must be idle: zero-initialized, or removed since it was last added. */
+void RgTurnScheduler_Add(RgTurnScheduler *self, RgTurnActor *actor, uint32_t speed, int32_t energy);
+
+/* stops scheduling `actor`. safe to call on actors in the current batch: their entry in the
+   batch becomes NULL, and the scheduler doesn't touch them again, so they may be freed. */
+void RgTurnScheduler_Remove(RgTurnScheduler *self, RgTurnActor *actor);
+
+/* changes the speed of a waiting actor, keeping the energy it has gathered so far. */
+void RgTurnScheduler_SetSpeed(RgTurnScheduler *self, RgTurnActor *actor, uint32_t speed);
+
+/*
+ * reschedules the previous batch after charging each actor its `cost`, then advances to the
+ * next tick anyone acts on and returns everyone acting on it. the batch has no ordering
+ * dependencies inside the scheduler, so it may be processed in parallel as long as only
+ * `cost` is written. entries of actors removed during the batch are NULL. returns 0 once no
+ * actors are left.
+ */
+RgSize RgTurnScheduler_NextBatch(RgTurnScheduler *self, RgTurnActor ***batch);
+
+#endif // RG_TURN_H_
@@ -7,6 +7,10 @@ typedef uint32_t RgPixel;
 typedef struct {
 	RgSize width, height;
 	float scaleX, scaleY;
+	bool debugContext; /* request a GL debug context and log its messages. */
+	bool printStartupTimes; /* log how long each startup step took, up to the first frame. */
+	const char *shaderCacheDir; /* directory for linked program binaries. NULL disables the cache. */
+	bool headless; /* keep the window in memory only: no display, no GL context, no input. */
 } RgWindowInitInfo;
 
 typedef struct {
@@ -14,6 +18,8 @@ typedef struct {
 	RgSize bufferWidth, bufferHeight;
 	RgPixel *buffer;
 	struct { float x, y; } scale;
+	RgSize presentedFrames; /* frames presented with RgWindow_Refresh. */
+	RgSize skippedFrames; /* RgWindow_BeginFrame calls that found nothing to draw. */
 	struct RgWindowImpl *impl_;
 } RgWindow;
 
@@ -30,6 +36,16 @@ void RgWindow_DeInit(RgWindow *self);
 [[nodiscard]] bool RgWindow_ShouldStop(RgWindow *self);
 void RgWindow_Clear(RgWindow *self, float r, float g, float b, float a);
 void RgWindow_Refresh(RgWindow *self);
+/*
+ * idle-aware frame pacing. unless `busy` (e.g. animations or background work are pending) or
+ * something already happened since the last refresh, blocks until input arrives, the window is
+ * resized or exposed, RgWindow_Wake is called, or `timeout` seconds pass (0 waits indefinitely).
+ * an exposed window is re-presented from the last frame without involving the caller.
+ * returns whether the caller should draw and refresh a frame; false counts as a skipped frame.
+ */
+[[nodiscard]] bool RgWindow_BeginFrame(RgWindow *self, bool busy, double timeout);
+/* makes the next or current RgWindow_BeginFrame return true. callable from any thread. */
+void RgWindow_Wake(RgWindow *self);
 [[nodiscard]] bool RgWindow_IsKeyDown(RgWindow *self, RgKey key);
 [[nodiscard]] RgKeyState RgWindow_GetKeyState(RgWindow *self, RgKey key);
 [[nodiscard]] float RgWindow_GetTime(RgWindow *self);
@@ -0,0 +1,64 @@
+#ifndef RG_WORLD_H_
+#define RG_WORLD_H_
+#include <Rogue/Core.h>
+#include <Rogue/Random.h>
+
+#define RG_CHUNK_SHIFT 5
+#define RG_CHUNK_SIZE (1 << RG_CHUNK_SHIFT) /* side length of a chunk in tiles. */
+#define RG_CHUNK_AREA (RG_CHUNK_SIZE * RG_CHUNK_SIZE)
+
+/* chunk coordinate containing tile coordinate `tile`, rounding towards negative infinity. */
+static inline int32_t RgWorld_ChunkCoord(int32_t tile) {
+	return tile >= 0 ? tile / RG_CHUNK_SIZE : (int32_t)(-((-(int64_t)tile - 1) / RG_CHUNK_SIZE) - 1);
+}
+
+typedef enum : uint8_t {
+	RG_TILE_FLAG_OPAQUE = 1 << 0, /* blocks light and line of sight. */
+	RG_TILE_FLAG_SOLID = 1 << 1, /* blocks movement. */
+} RgTileFlag;
+
+/* all world types are plain, fixed-size data: they are saved and mapped back byte-for-byte. */
+typedef struct {
+	uint8_t glyph; /* symbol value to draw. */
+	uint8_t color; /* palette index. */
+	uint8_t flags; /* RgTileFlag bits. */
+	uint8_t material; /* game-defined material id. */
+} RgTile;
+
+typedef struct {
+	int32_t x, y; /* position in chunks, not tiles. */
+	RgTile tiles[RG_CHUNK_AREA]; /* row-major. */
+} RgChunk;
+
+typedef struct {
+	uint32_t id;
+	int32_t x, y; /* position in tiles. */
+	uint8_t glyph, color;
+	uint16_t flags;
+} RgEntity;
+
+static_assert(sizeof(RgTile) == 4, "RgTile layout is part of the snapshot format");
+static_assert(sizeof(RgChunk) == 8 + 4 * RG_CHUNK_AREA, "RgChunk layout is part of the snapshot format");
+static_assert(sizeof(RgEntity) == 16, "RgEntity layout is part of the snapshot format");
+
+typedef struct {
+	RgChunk *chunks; /* owned unless chunkCapacity is 0, e.g. when mapped from a snapshot. */
+	RgSize chunkCount, chunkCapacity;
+	RgEntity *entities; /* owned unless entityCapacity is 0. */
+	RgSize entityCount, entityCapacity;
+	RgRng rng;
+	uint32_t *chunkTable; /* open-addressed chunk index + 1 per slot, 0 when empty. built lazily. */
+	RgSize chunkTableCapacity, chunkTableCount;
+} RgWorld;
+
+void RgWorld_Init(RgWorld *self, uint64_t seed);
+void RgWorld_DeInit(RgWorld *self);
+/* appends a zeroed chunk. the returned pointer is invalidated by the next add. */
+RgChunk *RgWorld_AddChunk(RgWorld *self, int32_t x, int32_t y);
+[[nodiscard]] RgChunk *RgWorld_GetChunk(RgWorld *self, int32_t x, int32_t y);
+/* tile at tile coordinates (x, y), or NULL if its chunk isn't loaded. */
+[[nodiscard]] RgTile *RgWorld_GetTile(RgWorld *self, int32_t x, int32_t y);
+/* appends a zeroed entity. the returned pointer is invalidated by the next add. */
+RgEntity *RgWorld_AddEntity(RgWorld *self);
+
+#endif // RG_WORLD_H_
@@ -0,0 +1,493 @@
+#define _POSIX_C_SOURCE 200809L
+#include <Rogue/Asset.h>
+#include <Rogue/Core.h>
+#include <errno.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define RG_PSF1_MAGIC_ 0x0436u
+#define RG_PSF1_MODE_512_ 0x01u
+#define RG_PSF1_MODE_HAS_TABLE_ 0x06u /* either of the two table flags. */
+#define RG_PSF2_MAGIC_ 0x864AB572u
+#define RG_PSF2_FLAG_HAS_TABLE_ 0x01u
+#define RG_FONT_MAX_GLYPH_WIDTH_ 64 /* a glyph row is one 64-bit word. */
+#define RG_FONT_MAX_GLYPH_HEIGHT_ 256
+#define RG_FONT_UNMAPPED_ SIZE_MAX
+
+/* maps `path` read-only. returns NULL after logging on failure. */
+static void *RgAsset_Map_(const char *path, RgSize *size) {
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		RgLogError("Failed to open %s: %s", path, strerror(errno));
+		return NULL;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		RgLogError("%s is empty or unreadable.", path);
+		close(fd);
+		return NULL;
+	}
+
+	void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED) {
+		RgLogError("Failed to map %s: %s", path, strerror(errno));
+		return NULL;
+	}
+
+	*size = st.st_size;
+	return data;
+}
+
+/* a range of text in a mapped file. mapped files aren't NUL-terminated, so nothing here reads
+   past `end`. */
+typedef struct {
+	const char *at, *end;
+} RgAssetText_;
+
+static inline bool RgAssetText_IsSpace_(char c) {
+	return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/* splits the next line off `text`, without its line ending. returns false at the end. */
+static bool RgAssetText_Line_(RgAssetText_ *text, RgAssetText_ *line) {
+	if (text->at >= text->end) return false;
+	const char *newline = memchr(text->at, '\n', text->end - text->at);
+	line->at = text->at;
+	line->end = newline != NULL ? newline : text->end;
+	text->at = newline != NULL ? newline + 1 : text->end;
+	return true;
+}
+
+/* splits the next whitespace-separated word off `line`. returns false if there is none. */
+static bool RgAssetText_Word_(RgAssetText_ *line, RgAssetText_ *word) {
+	while (line->at < line->end && RgAssetText_IsSpace_(*line->at)) ++line->at;
+	if (line->at == line->end) return false;
+	word->at = line->at;
+	while (line->at < line->end && !RgAssetText_IsSpace_(*line->at)) ++line->at;
+	word->end = line->at;
+	return true;
+}
+
+static bool RgAssetText_Is_(RgAssetText_ word, const char *keyword) {
+	RgSize length = strlen(keyword);
+	return (RgSize)(word.end - word.at) == length && memcmp(word.at, keyword, length) == 0;
+}
+
+/* parses the next word of `line` as a decimal integer. */
+static bool RgAssetText_Int_(RgAssetText_ *line, long *out) {
+	RgAssetText_ word;
+	if (!RgAssetText_Word_(line, &word)) return false;
+
+	bool negative = *word.at == '-';
+	if (negative || *word.at == '+') ++word.at;
+	if (word.at == word.end || word.end - word.at > 9) return false;
+
+	long value = 0;
+	for (; word.at < word.end; ++word.at) {
+		if (*word.at < '0' || *word.at > '9') return false;
+		value = value * 10 + (*word.at - '0');
+	}
+	*out = negative ? -value : value;
+	return true;
+}
+
+static inline int RgAssetText_HexDigit_(char c) {
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+/* parses exactly `digits` hex digits at `at`. returns -1 if any of them isn't one. */
+static long RgAssetText_Hex_(const char *at, RgSize digits) {
+	long value = 0;
+	for (RgSize i = 0; i < digits; ++i) {
+		int digit = RgAssetText_HexDigit_(at[i]);
+		if (digit < 0) return -1;
+		value = value << 4 | digit;
+	}
+	return value;
+}
+
+/* allocates the ASCII map with every symbol value unmapped. */
+static RgSize *RgFontFile_AllocMap_(void) {
+	RgSize *map = RgAllocArray(sizeof(*map), 256);
+	if (map == NULL) RgFail("Failed to allocate a font ASCII map.");
+	for (RgSize i = 0; i < 256; ++i) map[i] = RG_FONT_UNMAPPED_;
+	return map;
+}
+
+/* points symbol values the font has no glyph for at its '?', or at no glyph for control codes. */
+static void RgFontFile_FillMap_(RgSize *map, RgSize symbolCount) {
+	RgSize fallback = map['?'] != RG_FONT_UNMAPPED_ ? map['?'] : symbolCount;
+	for (RgSize i = 0; i < 256; ++i)
+		if (map[i] == RG_FONT_UNMAPPED_) map[i] = i < 0x20 ? symbolCount : fallback;
+}
+
+static inline void RgFontFile_MapCodepoint_(RgSize *map, uint32_t codepoint, RgSize glyph) {
+	// symbol values are read as Latin-1, the only code points a char can hold:
+	if (codepoint < 256 && map[codepoint] == RG_FONT_UNMAPPED_) map[codepoint] = glyph;
+}
+
+/* reads the PSF1 unicode table: per glyph, u16 code points up to 0xFFFF, with sequences after
+   0xFFFE that don't map single symbols. */
+static bool RgFontFile_ReadPsf1Table_(RgSize *map, const uint8_t *at, const uint8_t *end, RgSize glyphCount) {
+	for (RgSize glyph = 0; glyph < glyphCount; ++glyph) {
+		bool sequences = false;
+		for (;;) {
+			if (end - at < 2) return false;
+			uint16_t value = (uint16_t)(at[0] | at[1] << 8);
+			at += 2;
+			if (value == 0xFFFF) break;
+			if (value == 0xFFFE) sequences = true;
+			else if (!sequences) RgFontFile_MapCodepoint_(map, value, glyph);
+		}
+	}
+	return true;
+}
+
+/* reads the PSF2 unicode table: per glyph, UTF-8 code points up to 0xFF, with sequences after
+   0xFE. only one- and two-byte code points can map a symbol, so longer ones are skipped. */
+static bool RgFontFile_ReadPsf2Table_(RgSize *map, const uint8_t *at, const uint8_t *end, RgSize glyphCount) {
+	for (RgSize glyph = 0; glyph < glyphCount; ++glyph) {
+		bool sequences = false;
+		for (;;) {
+			if (at == end) return false;
+			uint8_t byte = *at++;
+			if (byte == 0xFF) break;
+			if (byte == 0xFE) sequences = true;
+			if (sequences) continue;
+
+			if (byte < 0x80) RgFontFile_MapCodepoint_(map, byte, glyph);
+			else if ((byte & 0xE0) == 0xC0 && at != end && (*at & 0xC0) == 0x80)
+				RgFontFile_MapCodepoint_(map, (uint32_t)(byte & 0x1F) << 6 | (*at++ & 0x3F), glyph);
+		}
+	}
+	return true;
+}
+
+static inline uint32_t RgFontFile_ReadU32_(const uint8_t *at) {
+	return (uint32_t)at[0] | (uint32_t)at[1] << 8 | (uint32_t)at[2] << 16 | (uint32_t)at[3] << 24;
+}
+
+static inline uint8_t RgFontFile_ReverseBits_(uint8_t byte) {
+	byte = (uint8_t)((byte & 0xF0) >> 4 | (byte & 0x0F) << 4);
+	byte = (uint8_t)((byte & 0xCC) >> 2 | (byte & 0x33) << 2);
+	return (uint8_t)((byte & 0xAA) >> 1 | (byte & 0x55) << 1);
+}
+
+/* expands the glyphs of a mapped PSF1 or PSF2 file into row words. */
+static bool RgFontFile_LoadPsf_(RgFontFile *self, const char *path, const uint8_t *data, RgSize size) {
+	RgSize glyphCount, glyphSize, width, height, headerSize;
+	bool hasTable, psf1 = (data[0] | data[1] << 8) == RG_PSF1_MAGIC_;
+
+	if (psf1 && size >= 4) {
+		headerSize = 4;
+		glyphCount = data[2] & RG_PSF1_MODE_512_ ? 512 : 256;
+		glyphSize = height = data[3];
+		width = 8;
+		hasTable = data[2] & RG_PSF1_MODE_HAS_TABLE_;
+	} else if (!psf1 && size >= 32) {
+		headerSize = RgFontFile_ReadU32_(data + 8);
+		hasTable = RgFontFile_ReadU32_(data + 12) & RG_PSF2_FLAG_HAS_TABLE_;
+		glyphCount = RgFontFile_ReadU32_(data + 16);
+		glyphSize = RgFontFile_ReadU32_(data + 20);
+		height = RgFontFile_ReadU32_(data + 24);
+		width = RgFontFile_ReadU32_(data + 28);
+	} else {
+		RgLogError("PSF font %s is truncated.", path);
+		return false;
+	}
+
+	if (width == 0 || height == 0 || width > RG_FONT_MAX_GLYPH_WIDTH_ || height > RG_FONT_MAX_GLYPH_HEIGHT_) {
+		RgLogError("PSF font %s has unsupported %zux%zu glyphs.", path, width, height);
+		return false;
+	}
+	RgSize stride = (width + 7) / 8;
+	if (glyphSize != stride * height) {
+		RgLogError("PSF font %s has %zu bytes per glyph, expected %zu.", path, glyphSize, stride * height);
+		return false;
+	}
+	if ((!psf1 && headerSize < 32) || headerSize > size || glyphCount == 0 || glyphCount > (size - headerSize) / glyphSize) {
+		RgLogError("PSF font %s is truncated.", path);
+		return false;
+	}
+
+	const uint8_t *glyphs = data + headerSize;
+	if (hasTable) {
+		self->asciiMap = RgFontFile_AllocMap_();
+		const uint8_t *table = glyphs + glyphCount * glyphSize;
+		bool ok = psf1
+			? RgFontFile_ReadPsf1Table_(self->asciiMap, table, data + size, glyphCount)
+			: RgFontFile_ReadPsf2Table_(self->asciiMap, table, data + size, glyphCount);
+		if (!ok) {
+			RgLogError("PSF font %s has a truncated unicode table.", path);
+			return false;
+		}
+		RgFontFile_FillMap_(self->asciiMap, glyphCount);
+	}
+
+	// PSF rows are bytes with the leftmost pixel in the high bit, the renderer wants it in bit 0:
+	self->rows = RgAllocArray(sizeof(*self->rows), glyphCount * height);
+	if (self->rows == NULL) RgFail("Failed to allocate glyphs for %s.", path);
+	uint64_t widthMask = width == 64 ? ~0ull : (1ull << width) - 1;
+	for (RgSize i = 0; i < glyphCount * height; ++i) {
+		uint64_t row = 0;
+		for (RgSize b = 0; b < stride; ++b)
+			row |= (uint64_t)RgFontFile_ReverseBits_(glyphs[i * stride + b]) << (8 * b);
+		self->rows[i] = row & widthMask;
+	}
+
+	self->font = (RgFont){
+		.symbolWidth = width, .symbolHeight = height,
+		.fontAsciiMap = self->asciiMap,
+		.symbolCount = glyphCount,
+		.symbolRows = self->rows,
+		.glyphWidth = width, .glyphHeight = height,
+	};
+	return true;
+}
+
+/* decodes a BDF font into row words. only glyphs for symbol values 0-255 are kept, each drawn
+   into a cell of the font's bounding box at its own offset. */
+static bool RgFontFile_LoadBdf_(RgFontFile *self, const char *path, const char *data, RgSize size) {
+	RgAssetText_ text = { data, data + size }, line, word;
+	long fontW = 0, fontH = 0, fontX = 0, fontY = 0;
+	long encoding = -1, glyphW = 0, glyphH = 0, glyphX = 0, glyphY = 0;
+	long row = -1; /* bitmap row being read, or -1 outside of BITMAP. */
+	RgSize glyphCount = 0;
+	uint64_t *glyph = NULL; /* rows of the glyph being read, or NULL if it is skipped. */
+	RgSize lineNumber = 0;
+
+	self->asciiMap = RgFontFile_AllocMap_();
+
+	while (RgAssetText_Line_(&text, &line)) {
+		++lineNumber;
+		if (row >= 0) {
+			RgAssetText_ rowText = line;
+			bool hasWord = RgAssetText_Word_(&rowText, &word);
+			if (hasWord && RgAssetText_Is_(word, "ENDCHAR")) {
+				row = -1;
+				continue;
+			}
+			if (!hasWord || glyph == NULL || row >= glyphH) { ++row; continue; }
+
+			// each row is ceil(width / 8) hex bytes, leftmost pixel in the high bit. the glyph's
+			// box sits on the baseline at its own offset, the cell is the font's box:
+			long y = (fontY + fontH) - (glyphY + glyphH) + row;
+			for (long c = 0; c < glyphW; ++c) {
+				const char *digits = word.at + c / 8 * 2;
+				if (word.end - digits < 2) break;
+				long byte = RgAssetText_Hex_(digits, 2);
+				if (byte < 0 || !(byte >> (7 - c % 8) & 1)) continue;
+
+				long x = glyphX - fontX + c;
+				if (x < 0 || x >= fontW || y < 0 || y >= fontH) continue;
+				glyph[y] |= 1ull << x;
+			}
+			++row;
+			continue;
+		}
+
+		if (!RgAssetText_Word_(&line, &word)) continue;
+
+		if (RgAssetText_Is_(word, "FONTBOUNDINGBOX")) {
+			if (!RgAssetText_Int_(&line, &fontW) || !RgAssetText_Int_(&line, &fontH)
+				|| !RgAssetText_Int_(&line, &fontX) || !RgAssetText_Int_(&line, &fontY)) goto malformed;
+			if (fontW <= 0 || fontH <= 0 || fontW > RG_FONT_MAX_GLYPH_WIDTH_ || fontH > RG_FONT_MAX_GLYPH_HEIGHT_) {
+				RgLogError("BDF font %s has unsupported %ldx%ld glyphs.", path, fontW, fontH);
+				return false;
+			}
+			if (self->rows != NULL) goto malformed;
+			self->rows = RgAllocArray(sizeof(*self->rows) * (RgSize)fontH, 256);
+			if (self->rows == NULL) RgFail("Failed to allocate glyphs for %s.", path);
+		} else if (RgAssetText_Is_(word, "STARTCHAR")) {
+			if (self->rows == NULL) goto malformed;
+			encoding = -1;
+			glyphW = glyphH = glyphX = glyphY = 0;
+		} else if (RgAssetText_Is_(word, "ENCODING")) {
+			if (!RgAssetText_Int_(&line, &encoding)) goto malformed;
+		} else if (RgAssetText_Is_(word, "BBX")) {
+			if (!RgAssetText_Int_(&line, &glyphW) || !RgAssetText_Int_(&line, &glyphH)
+				|| !RgAssetText_Int_(&line, &glyphX) || !RgAssetText_Int_(&line, &glyphY)) goto malformed;
+			if (glyphW < 0 || glyphH < 0) goto malformed;
+		} else if (RgAssetText_Is_(word, "BITMAP")) {
+			if (self->rows == NULL) goto malformed;
+			row = 0;
+			glyph = NULL;
+			// unencoded glyphs, glyphs past Latin-1 and repeated encodings can't be drawn:
+			if (encoding >= 0 && encoding < 256 && self->asciiMap[encoding] == RG_FONT_UNMAPPED_) {
+				self->asciiMap[encoding] = glyphCount;
+				glyph = self->rows + glyphCount++ * (RgSize)fontH;
+			}
+		}
+	}
+
+	if (self->rows == NULL || glyphCount == 0) {
+		RgLogError("BDF font %s has no glyphs for symbol values 0-255.", path);
+		return false;
+	}
+
+	RgFontFile_FillMap_(self->asciiMap, glyphCount);
+	self->font = (RgFont){
+		.symbolWidth = (RgSize)fontW, .symbolHeight = (RgSize)fontH,
+		.fontAsciiMap = self->asciiMap,
+		.symbolCount = glyphCount,
+		.symbolRows = self->rows,
+		.glyphWidth = (RgSize)fontW, .glyphHeight = (RgSize)fontH,
+	};
+	return true;
+
+malformed:
+	RgLogError("BDF font %s is malformed at line %zu.", path, lineNumber);
+	return false;
+}
+
+bool RgFontFile_Load(RgFontFile *self, const char *path) {
+	*self = (RgFontFile){0};
+
+	RgSize size;
+	uint8_t *data = RgAsset_Map_(path, &size);
+	if (data == NULL) return false;
+
+	bool ok;
+	if ((size >= 2 && (data[0] | data[1] << 8) == RG_PSF1_MAGIC_)
+		|| (size >= 4 && RgFontFile_ReadU32_(data) == RG_PSF2_MAGIC_)) {
+		ok = RgFontFile_LoadPsf_(self, path, data, size);
+	} else if (size >= 9 && memcmp(data, "STARTFONT", 9) == 0) {
+		ok = RgFontFile_LoadBdf_(self, path, (const char *)data, size);
+	} else {
+		RgLogError("%s is neither a PSF nor a BDF font.", path);
+		ok = false;
+	}
+	// every glyph was expanded out of the file, so nothing keeps pointing into it:
+	munmap(data, size);
+
+	if (!ok) RgFontFile_DeInit(self);
+	return ok;
+}
+
+void RgFontFile_DeInit(RgFontFile *self) {
+	RgDeAlloc(self->rows);
+	RgDeAlloc(self->asciiMap);
+	*self = (RgFontFile){0};
+}
+
+/* parses one palette line into 0xRRGGBB. returns false for lines that aren't a color. */
+static bool RgPalette_ParseLine_(RgAssetText_ line, uint32_t *rgb) {
+	RgAssetText_ first;
+	if (!RgAssetText_Word_(&line, &first)) return false;
+
+	// hex, with or without '#'. a GIMP comment is '#' followed by anything else:
+	RgAssetText_ hex = first;
+	if (*hex.at == '#') ++hex.at;
+	if (hex.end - hex.at == 6) {
+		long value = RgAssetText_Hex_(hex.at, 6);
+		if (value >= 0) {
+			*rgb = (uint32_t)value;
+			return true;
+		}
+	}
+
+	// GIMP: three decimal components, then an optional name:
+	RgAssetText_ components = { first.at, line.end };
+	long r, g, b;
+	if (!RgAssetText_Int_(&components, &r) || !RgAssetText_Int_(&components, &g) || !RgAssetText_Int_(&components, &b))
+		return false;
+	if (r < 0 || r > 255 || g < 0 || g > 255 || b < 0 || b > 255) return false;
+	*rgb = (uint32_t)(r << 16 | g << 8 | b);
+	return true;
+}
+
+bool RgPalette_Load(RgPalette *self, const char *path) {
+	*self = (RgPalette){0};
+
+	RgSize size;
+	const char *data = RgAsset_Map_(path, &size);
+	if (data == NULL) return false;
+
+	// symbol colors are a uint8_t, so more than 256 colors could never be used:
+	self->colors = RgAllocArray(sizeof(*self->colors), 256);
+	if (self->colors == NULL) RgFail("Failed to allocate a palette.");
+
+	RgAssetText_ text = { data, data + size }, line;
+	bool ok = true;
+	while (RgAssetText_Line_(&text, &line)) {
+		uint32_t rgb;
+		if (!RgPalette_ParseLine_(line, &rgb)) continue;
+		if (self->count == 256) {
+			RgLogError("Palette %s has more than 256 colors.", path);
+			ok = false;
+			break;
+		}
+		// RgPixel keeps red in the low byte:
+		self->colors[self->count++] = (rgb & 0xFF) << 16 | (rgb & 0xFF00) | rgb >> 16;
+	}
+	munmap((void *)data, size);
+
+	if (ok && self->count == 0) {
+		RgLogError("Palette %s has no colors.", path);
+		ok = false;
+	}
+	if (!ok) RgPalette_DeInit(self);
+	return ok;
+}
+
+void RgPalette_DeInit(RgPalette *self) {
+	RgDeAlloc(self->colors);
+	*self = (RgPalette){0};
+}
+
+static char *RgAssetLoad_CopyPath_(const char *path) {
+	if (path == NULL) return NULL;
+	RgSize length = strlen(path) + 1;
+	char *copy = RgAlloc(length);
+	if (copy == NULL) RgFail("Failed to copy asset path %s.", path);
+	return memcpy(copy, path, length);
+}
+
+static void RgAssetLoad_FontJob_(void *data) {
+	RgAssetLoad *self = data;
+	self->fontLoaded = RgFontFile_Load(&self->font, self->fontPath);
+}
+
+static void RgAssetLoad_PaletteJob_(void *data) {
+	RgAssetLoad *self = data;
+	self->paletteLoaded = RgPalette_Load(&self->palette, self->palettePath);
+}
+
+void RgAssetLoad_Start(RgAssetLoad *self, RgJobSystem *jobs, const char *fontPath, const char *palettePath) {
+	*self = (RgAssetLoad){ .jobs = jobs };
+	atomic_init(&self->pending.pending, 0);
+	self->fontPath = RgAssetLoad_CopyPath_(fontPath);
+	self->palettePath = RgAssetLoad_CopyPath_(palettePath);
+
+	// separate jobs, so a font and a palette load side by side:
+	if (self->fontPath != NULL) RgJobSystem_Spawn(jobs, &RgAssetLoad_FontJob_, self, &self->pending);
+	if (self->palettePath != NULL) RgJobSystem_Spawn(jobs, &RgAssetLoad_PaletteJob_, self, &self->pending);
+}
+
+bool RgAssetLoad_IsDone(RgAssetLoad *self) {
+	// with no other workers, nothing would ever pick up the jobs, so make some progress here:
+	if (self->jobs->workerCount == 1) RgJobSystem_RunOne(self->jobs);
+	return atomic_load_explicit(&self->pending.pending, memory_order_acquire) == 0;
+}
+
+void RgAssetLoad_Wait(RgAssetLoad *self) {
+	RgJobSystem_Wait(self->jobs, &self->pending);
+}
+
+void RgAssetLoad_DeInit(RgAssetLoad *self) {
+	if (self->jobs != NULL) RgAssetLoad_Wait(self);
+	if (self->fontLoaded) RgFontFile_DeInit(&self->font);
+	if (self->paletteLoaded) RgPalette_DeInit(&self->palette);
+	RgDeAlloc(self->fontPath);
+	RgDeAlloc(self->palettePath);
+	*self = (RgAssetLoad){0};
+}
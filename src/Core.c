@@ -1,7 +1,9 @@
+#define _POSIX_C_SOURCE 200809L
 #include <Rogue/Core.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <time.h>
 
 void RgFail(const char *fmt, ...) {
 	va_list va;
@@ -22,6 +24,106 @@ void RgLogError(const char *fmt, ...) {
 	fputs("\033[m\n", stderr);
 }
 
+void RgLogInfo(const char *fmt, ...) {
+	va_list va;
+	va_start(va, fmt);
+	vfprintf(stderr, fmt, va);
+	va_end(va);
+	fputc('\n', stderr);
+}
+
 void *RgAllocArray(size_t elemSize, size_t numElems) { return calloc(numElems, elemSize); }
 void *RgAlloc(size_t size) { return malloc(size); }
+void *RgAllocAligned(size_t alignment, size_t size) { return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment); }
 void RgDeAlloc(void *ptr) { free(ptr); }
+
+uint64_t RgTimeNs(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#define RG_HASH_P1_ 0x9E3779B185EBCA87ull
+#define RG_HASH_P2_ 0xC2B2AE3D27D4EB4Full
+#define RG_HASH_P3_ 0x165667B19E3779F9ull
+#define RG_HASH_P4_ 0x85EBCA77C2B2AE63ull
+#define RG_HASH_P5_ 0x27D4EB2F165667C5ull
+
+static inline uint64_t RgHash_Rotl_(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+static inline uint64_t RgHash_Read64_(const uint8_t *p) {
+	uint64_t v;
+	__builtin_memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint32_t RgHash_Read32_(const uint8_t *p) {
+	uint32_t v;
+	__builtin_memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint64_t RgHash_Round_(uint64_t acc, uint64_t input) {
+	acc += input * RG_HASH_P2_;
+	acc = RgHash_Rotl_(acc, 31);
+	return acc * RG_HASH_P1_;
+}
+
+static inline uint64_t RgHash_Merge_(uint64_t acc, uint64_t val) {
+	acc ^= RgHash_Round_(0, val);
+	return acc * RG_HASH_P1_ + RG_HASH_P4_;
+}
+
+uint64_t RgHash(const void *data, RgSize size, uint64_t seed) {
+	const uint8_t *p = data;
+	const uint8_t *end = p + size;
+	uint64_t h;
+
+	if (size >= 32) {
+		uint64_t v1 = seed + RG_HASH_P1_ + RG_HASH_P2_;
+		uint64_t v2 = seed + RG_HASH_P2_;
+		uint64_t v3 = seed;
+		uint64_t v4 = seed - RG_HASH_P1_;
+
+		// four independent lanes so the multiplies pipeline:
+		for (; end - p >= 32; p += 32) {
+			v1 = RgHash_Round_(v1, RgHash_Read64_(p));
+			v2 = RgHash_Round_(v2, RgHash_Read64_(p + 8));
+			v3 = RgHash_Round_(v3, RgHash_Read64_(p + 16));
+			v4 = RgHash_Round_(v4, RgHash_Read64_(p + 24));
+		}
+
+		h = RgHash_Rotl_(v1, 1) + RgHash_Rotl_(v2, 7) + RgHash_Rotl_(v3, 12) + RgHash_Rotl_(v4, 18);
+		h = RgHash_Merge_(h, v1);
+		h = RgHash_Merge_(h, v2);
+		h = RgHash_Merge_(h, v3);
+		h = RgHash_Merge_(h, v4);
+	} else {
+		h = seed + RG_HASH_P5_;
+	}
+
+	h += (uint64_t)size;
+
+	for (; end - p >= 8; p += 8) {
+		h ^= RgHash_Round_(0, RgHash_Read64_(p));
+		h = RgHash_Rotl_(h, 27) * RG_HASH_P1_ + RG_HASH_P4_;
+	}
+
+	if (end - p >= 4) {
+		h ^= (uint64_t)RgHash_Read32_(p) * RG_HASH_P1_;
+		h = RgHash_Rotl_(h, 23) * RG_HASH_P2_ + RG_HASH_P3_;
+		p += 4;
+	}
+
+	for (; p < end; ++p) {
+		h ^= (uint64_t)*p * RG_HASH_P5_;
+		h = RgHash_Rotl_(h, 11) * RG_HASH_P1_;
+	}
+
+	h ^= h >> 33;
+	h *= RG_HASH_P2_;
+	h ^= h >> 29;
+	h *= RG_HASH_P3_;
+	h ^= h >> 32;
+	return h;
+}
@@ -0,0 +1,427 @@
+#define _POSIX_C_SOURCE 200809L
+#include <Rogue/Job.h>
+#include <Rogue/Core.h>
+#include <stdatomic.h>
+#include <threads.h>
+#include <unistd.h>
+
+#define RG_JOB_DEQUE_CAPACITY 4096 /* per worker. must be a power of two. */
+#define RG_JOB_SPIN_ROUNDS 64 /* failed steal rounds before a worker goes to sleep. */
+
+typedef struct {
+	RgJobFunc *func;
+	void *data;
+	RgJobCounter *counter;
+} RgJob_;
+
+/* deque slots are read by thieves while the owner may be writing them, hence atomic fields. */
+typedef struct {
+	_Atomic(RgJobFunc *) func;
+	_Atomic(void *) data;
+	_Atomic(RgJobCounter *) counter;
+} RgJobSlot_;
+
+/* Chase-Lev deque: the owner pushes and takes at `bottom`, thieves steal at `top`. */
+typedef struct {
+	alignas(64) atomic_int_fast64_t top;
+	alignas(64) atomic_int_fast64_t bottom;
+	uint64_t victimSeed; /* owner-only xorshift state for picking steal victims. */
+	thrd_t thread;
+	RgJobSlot_ slots[RG_JOB_DEQUE_CAPACITY];
+} RgJobWorker_;
+
+/* mutex-protected FIFO for the main-thread queue and for spawns from foreign threads. */
+typedef struct {
+	mtx_t lock;
+	RgJob_ *jobs;
+	RgSize head, count, capacity;
+	atomic_size_t size; /* mirrors count, for a lock-free emptiness check. */
+} RgJobQueue_;
+
+struct RgJobSystemImpl {
+	RgJobWorker_ *workers;
+	RgSize workerCount;
+	RgJobQueue_ mainQueue, sharedQueue;
+	atomic_bool stopping;
+	atomic_size_t sleeping;
+	mtx_t sleepLock;
+	cnd_t wake;
+};
+
+typedef struct {
+	struct RgJobSystemImpl *system;
+	RgSize index;
+} RgJobThread_;
+
+static thread_local RgJobThread_ RgJob_CurrentThread_ = { NULL, SIZE_MAX };
+
+static inline void RgJob_Pause_(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	__asm__ volatile("yield");
+#endif
+}
+
+static void RgJobQueue_Init_(RgJobQueue_ *self) {
+	if (mtx_init(&self->lock, mtx_plain) != thrd_success) RgFail("Failed to create job queue lock.");
+	self->jobs = NULL;
+	self->head = self->count = self->capacity = 0;
+	atomic_init(&self->size, 0);
+}
+
+static void RgJobQueue_DeInit_(RgJobQueue_ *self) {
+	mtx_destroy(&self->lock);
+	RgDeAlloc(self->jobs);
+	self->jobs = NULL;
+}
+
+static void RgJobQueue_Push_(RgJobQueue_ *self, RgJob_ job) {
+	mtx_lock(&self->lock);
+
+	if (self->count == self->capacity) {
+		RgSize newCapacity = Rg_Max(self->capacity * 2, (RgSize)64);
+		RgJob_ *jobs = RgAllocArray(sizeof(*jobs), newCapacity);
+		if (jobs == NULL) RgFail("Failed to grow job queue to %zu jobs.", newCapacity);
+		for (RgSize i = 0; i < self->count; ++i)
+			jobs[i] = self->jobs[(self->head + i) % self->capacity];
+		RgDeAlloc(self->jobs);
+		self->jobs = jobs;
+		self->head = 0;
+		self->capacity = newCapacity;
+	}
+
+	self->jobs[(self->head + self->count) % self->capacity] = job;
+	atomic_store(&self->size, ++self->count);
+	mtx_unlock(&self->lock);
+}
+
+static bool RgJobQueue_Pop_(RgJobQueue_ *self, RgJob_ *job) {
+	if (atomic_load_explicit(&self->size, memory_order_relaxed) == 0) return false;
+
+	mtx_lock(&self->lock);
+	bool found = self->count != 0;
+	if (found) {
+		*job = self->jobs[self->head];
+		self->head = (self->head + 1) % self->capacity;
+		atomic_store(&self->size, --self->count);
+	}
+	mtx_unlock(&self->lock);
+	return found;
+}
+
+static bool RgJobWorker_Push_(RgJobWorker_ *self, RgJob_ job) {
+	int_fast64_t b = atomic_load_explicit(&self->bottom, memory_order_relaxed);
+	int_fast64_t t = atomic_load_explicit(&self->top, memory_order_acquire);
+	if (b - t >= RG_JOB_DEQUE_CAPACITY) return false;
+
+	RgJobSlot_ *slot = &self->slots[b & (RG_JOB_DEQUE_CAPACITY - 1)];
+	atomic_store_explicit(&slot->func, job.func, memory_order_relaxed);
+	atomic_store_explicit(&slot->data, job.data, memory_order_relaxed);
+	atomic_store_explicit(&slot->counter, job.counter, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&self->bottom, b + 1, memory_order_relaxed);
+	return true;
+}
+
+static inline RgJob_ RgJobSlot_Read_(RgJobSlot_ *slot) {
+	return (RgJob_){
+		.func = atomic_load_explicit(&slot->func, memory_order_relaxed),
+		.data = atomic_load_explicit(&slot->data, memory_order_relaxed),
+		.counter = atomic_load_explicit(&slot->counter, memory_order_relaxed),
+	};
+}
+
+static bool RgJobWorker_Take_(RgJobWorker_ *self, RgJob_ *job) {
+	int_fast64_t b = atomic_load_explicit(&self->bottom, memory_order_relaxed) - 1;
+	atomic_store_explicit(&self->bottom, b, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	int_fast64_t t = atomic_load_explicit(&self->top, memory_order_relaxed);
+
+	if (t > b) {
+		atomic_store_explicit(&self->bottom, b + 1, memory_order_relaxed);
+		return false;
+	}
+
+	*job = RgJobSlot_Read_(&self->slots[b & (RG_JOB_DEQUE_CAPACITY - 1)]);
+	if (t != b) return true;
+
+	// last job in the deque: race thieves for it.
+	bool won = atomic_compare_exchange_strong_explicit(&self->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+	atomic_store_explicit(&self->bottom, b + 1, memory_order_relaxed);
+	return won;
+}
+
+static bool RgJobWorker_Steal_(RgJobWorker_ *self, RgJob_ *job) {
+	int_fast64_t t = atomic_load_explicit(&self->top, memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	int_fast64_t b = atomic_load_explicit(&self->bottom, memory_order_acquire);
+	if (t >= b) return false;
+
+	*job = RgJobSlot_Read_(&self->slots[t & (RG_JOB_DEQUE_CAPACITY - 1)]);
+	return atomic_compare_exchange_strong_explicit(&self->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+}
+
+static void RgJob_Execute_(RgJob_ job) {
+	job.func(job.data);
+	if (job.counter != NULL) atomic_fetch_sub_explicit(&job.counter->pending, 1, memory_order_acq_rel);
+}
+
+static bool RgJobSystem_HasWork_(struct RgJobSystemImpl *impl) {
+	if (atomic_load(&impl->sharedQueue.size) != 0) return true;
+	for (RgSize i = 0; i < impl->workerCount; ++i)
+		if (atomic_load(&impl->workers[i].bottom) > atomic_load(&impl->workers[i].top)) return true;
+	return false;
+}
+
+static void RgJobSystem_WakeOne_(struct RgJobSystemImpl *impl) {
+	// pairs with the sleeper's increment of `sleeping` before it re-checks for work:
+	atomic_thread_fence(memory_order_seq_cst);
+	if (atomic_load_explicit(&impl->sleeping, memory_order_relaxed) == 0) return;
+	mtx_lock(&impl->sleepLock);
+	cnd_signal(&impl->wake);
+	mtx_unlock(&impl->sleepLock);
+}
+
+static bool RgJobSystem_FindJob_(struct RgJobSystemImpl *impl, RgSize index, RgJob_ *job) {
+	RgJobWorker_ *self = &impl->workers[index];
+	if (RgJobWorker_Take_(self, job)) return true;
+	if (RgJobQueue_Pop_(&impl->sharedQueue, job)) return true;
+	if (impl->workerCount < 2) return false;
+
+	// start at a random victim so thieves spread out instead of all hitting worker 0:
+	uint64_t x = self->victimSeed;
+	x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+	self->victimSeed = x;
+
+	RgSize start = x % impl->workerCount;
+	for (RgSize i = 0; i < impl->workerCount; ++i) {
+		RgSize victim = (start + i) % impl->workerCount;
+		if (victim != index && RgJobWorker_Steal_(&impl->workers[victim], job)) return true;
+	}
+	return false;
+}
+
+static int RgJobSystem_WorkerMain_(void *arg) {
+	RgJobThread_ *thread = arg;
+	struct RgJobSystemImpl *impl = thread->system;
+	RgJob_CurrentThread_ = *thread;
+	RgDeAlloc(thread);
+
+	RgSize index = RgJob_CurrentThread_.index;
+	RgSize idleRounds = 0;
+
+	while (!atomic_load_explicit(&impl->stopping, memory_order_relaxed)) {
+		RgJob_ job;
+		if (RgJobSystem_FindJob_(impl, index, &job)) {
+			RgJob_Execute_(job);
+			idleRounds = 0;
+			continue;
+		}
+
+		if (++idleRounds < RG_JOB_SPIN_ROUNDS) {
+			RgJob_Pause_();
+			continue;
+		}
+
+		mtx_lock(&impl->sleepLock);
+		atomic_fetch_add(&impl->sleeping, 1);
+		if (!atomic_load(&impl->stopping) && !RgJobSystem_HasWork_(impl))
+			cnd_wait(&impl->wake, &impl->sleepLock);
+		atomic_fetch_sub(&impl->sleeping, 1);
+		mtx_unlock(&impl->sleepLock);
+		idleRounds = 0;
+	}
+
+	return 0;
+}
+
+static RgSize RgJobSystem_HardwareThreads_(void) {
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (RgSize)count : 1;
+}
+
+void RgJobSystem_Init(RgJobSystem *self, const RgJobSystemInitInfo *info) {
+	self->workerCount = info->workerCount != 0 ? info->workerCount : RgJobSystem_HardwareThreads_();
+	self->impl_ = RgAlloc(sizeof(*self->impl_));
+
+	struct RgJobSystemImpl *impl = self->impl_;
+	impl->workerCount = self->workerCount;
+	impl->workers = RgAllocAligned(alignof(RgJobWorker_), sizeof(*impl->workers) * impl->workerCount);
+	if (impl->workers == NULL) RgFail("Failed to allocate %zu job workers.", impl->workerCount);
+
+	RgJobQueue_Init_(&impl->mainQueue);
+	RgJobQueue_Init_(&impl->sharedQueue);
+	atomic_init(&impl->stopping, false);
+	atomic_init(&impl->sleeping, 0);
+	if (mtx_init(&impl->sleepLock, mtx_plain) != thrd_success || cnd_init(&impl->wake) != thrd_success)
+		RgFail("Failed to create job system wake-up primitives.");
+
+	for (RgSize i = 0; i < impl->workerCount; ++i) {
+		atomic_init(&impl->workers[i].top, 0);
+		atomic_init(&impl->workers[i].bottom, 0);
+		impl->workers[i].victimSeed = 0x9E3779B97F4A7C15ull * (i + 1);
+	}
+
+	RgJob_CurrentThread_ = (RgJobThread_){ impl, 0 };
+
+	for (RgSize i = 1; i < impl->workerCount; ++i) {
+		RgJobThread_ *thread = RgAlloc(sizeof(*thread));
+		*thread = (RgJobThread_){ impl, i };
+		if (thrd_create(&impl->workers[i].thread, &RgJobSystem_WorkerMain_, thread) != thrd_success)
+			RgFail("Failed to start job worker %zu.", i);
+	}
+}
+
+/* runs queued jobs, main-thread ones included, on the calling thread until every queue is empty.
+   takes from worker 0's deque, so nothing else may be using that worker. */
+static void RgJobSystem_Drain_(struct RgJobSystemImpl *impl) {
+	RgJob_ job;
+	while (RgJobQueue_Pop_(&impl->mainQueue, &job) || RgJobSystem_FindJob_(impl, 0, &job))
+		RgJob_Execute_(job);
+}
+
+void RgJobSystem_DeInit(RgJobSystem *self) {
+	struct RgJobSystemImpl *impl = self->impl_;
+
+	// dropping a queued job would leave whoever waits on its counter hanging, so help the workers
+	// empty the queues first:
+	RgJobSystem_Drain_(impl);
+
+	mtx_lock(&impl->sleepLock);
+	atomic_store(&impl->stopping, true);
+	cnd_broadcast(&impl->wake);
+	mtx_unlock(&impl->sleepLock);
+
+	for (RgSize i = 1; i < impl->workerCount; ++i)
+		thrd_join(impl->workers[i].thread, NULL);
+
+	// jobs still running above may have queued more before their worker stopped:
+	RgJobSystem_Drain_(impl);
+
+	if (RgJob_CurrentThread_.system == impl)
+		RgJob_CurrentThread_ = (RgJobThread_){ NULL, SIZE_MAX };
+
+	cnd_destroy(&impl->wake);
+	mtx_destroy(&impl->sleepLock);
+	RgJobQueue_DeInit_(&impl->sharedQueue);
+	RgJobQueue_DeInit_(&impl->mainQueue);
+	RgDeAlloc(impl->workers);
+
+	RgDeAlloc(impl);
+	self->impl_ = NULL;
+}
+
+void RgJobSystem_Spawn(RgJobSystem *self, RgJobFunc *func, void *data, RgJobCounter *counter) {
+	if (counter != NULL) atomic_fetch_add_explicit(&counter->pending, 1, memory_order_relaxed);
+
+	RgJob_ job = { func, data, counter };
+	RgSize index = RgJobSystem_WorkerIndex(self);
+
+	if (index == SIZE_MAX) {
+		RgJobQueue_Push_(&self->impl_->sharedQueue, job);
+	} else if (!RgJobWorker_Push_(&self->impl_->workers[index], job)) {
+		// the deque is full, so there is plenty of parallel work already: just run it here.
+		RgJob_Execute_(job);
+		return;
+	}
+
+	RgJobSystem_WakeOne_(self->impl_);
+}
+
+void RgJobSystem_SpawnMain(RgJobSystem *self, RgJobFunc *func, void *data, RgJobCounter *counter) {
+	if (counter != NULL) atomic_fetch_add_explicit(&counter->pending, 1, memory_order_relaxed);
+	RgJobQueue_Push_(&self->impl_->mainQueue, (RgJob_){ func, data, counter });
+}
+
+RgSize RgJobSystem_RunMain(RgJobSystem *self) {
+	if (RgJobSystem_WorkerIndex(self) != 0) RgFail("RgJobSystem_RunMain called off the main thread.");
+
+	RgSize count = 0;
+	RgJob_ job;
+	while (RgJobQueue_Pop_(&self->impl_->mainQueue, &job)) {
+		RgJob_Execute_(job);
+		++count;
+	}
+	return count;
+}
+
+bool RgJobSystem_RunOne(RgJobSystem *self) {
+	RgSize index = RgJobSystem_WorkerIndex(self);
+	if (index == SIZE_MAX) return false;
+
+	RgJob_ job;
+	if (!RgJobSystem_FindJob_(self->impl_, index, &job)) return false;
+	RgJob_Execute_(job);
+	return true;
+}
+
+void RgJobSystem_Wait(RgJobSystem *self, RgJobCounter *counter) {
+	RgSize index = RgJobSystem_WorkerIndex(self);
+	RgSize idleRounds = 0;
+
+	while (atomic_load_explicit(&counter->pending, memory_order_acquire) != 0) {
+		RgJob_ job;
+		bool found = index != SIZE_MAX && (
+			(index == 0 && RgJobQueue_Pop_(&self->impl_->mainQueue, &job))
+			|| RgJobSystem_FindJob_(self->impl_, index, &job)
+		);
+
+		if (found) {
+			RgJob_Execute_(job);
+			idleRounds = 0;
+		} else if (++idleRounds < RG_JOB_SPIN_ROUNDS) {
+			RgJob_Pause_();
+		} else {
+			// the remaining jobs are running elsewhere; don't burn the core they might need.
+			thrd_yield();
+		}
+	}
+}
+
+typedef struct {
+	RgJobRangeFunc *func;
+	void *data;
+	RgSize end, grain;
+	atomic_size_t next;
+} RgJobParallelFor_;
+
+static void RgJobSystem_ParallelForJob_(void *data) {
+	RgJobParallelFor_ *loop = data;
+	for (;;) {
+		RgSize begin = atomic_fetch_add_explicit(&loop->next, loop->grain, memory_order_relaxed);
+		if (begin >= loop->end) break;
+		loop->func(loop->data, begin, Rg_Min(begin + loop->grain, loop->end));
+	}
+}
+
+void RgJobSystem_ParallelFor(RgJobSystem *self, RgSize begin, RgSize end, RgSize grain, RgJobRangeFunc *func, void *data) {
+	if (begin >= end) return;
+	RgSize count = end - begin;
+
+	// ~8 sub-ranges per worker leaves room for stealing to even out uneven costs:
+	if (grain == 0) grain = Rg_Max(count / (self->workerCount * 8), (RgSize)1);
+
+	RgSize chunks = (count + grain - 1) / grain;
+	if (chunks == 1) {
+		func(data, begin, end);
+		return;
+	}
+
+	// every helper pulls sub-ranges off a shared cursor until it runs dry, so helpers that
+	// start late just return. the caller is one of them.
+	RgJobParallelFor_ loop = { .func = func, .data = data, .end = end, .grain = grain };
+	atomic_init(&loop.next, begin);
+
+	RgJobCounter counter = {0};
+	RgSize helpers = Rg_Min(self->workerCount, chunks) - 1;
+	for (RgSize i = 0; i < helpers; ++i)
+		RgJobSystem_Spawn(self, &RgJobSystem_ParallelForJob_, &loop, &counter);
+
+	RgJobSystem_ParallelForJob_(&loop);
+	RgJobSystem_Wait(self, &counter);
+}
+
+RgSize RgJobSystem_WorkerIndex(RgJobSystem *self) {
+	return RgJob_CurrentThread_.system == self->impl_ ? RgJob_CurrentThread_.index : SIZE_MAX;
+}
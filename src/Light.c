@@ -0,0 +1,255 @@
+#include <Rogue/Light.h>
+#include <Rogue/Core.h>
+
+#define RG_LIGHT_SIDE_ (2 * RG_LIGHT_MAX_RADIUS + 1)
+
+/* xx, xy, yx, yy transforms from the first octant to each of the eight. */
+static const int RgLight_Octants_[8][4] = {
+	{ 1, 0, 0, 1 }, { 0, 1, 1, 0 }, { 0, -1, 1, 0 }, { -1, 0, 0, 1 },
+	{ -1, 0, 0, -1 }, { 0, -1, -1, 0 }, { 0, 1, -1, 0 }, { 1, 0, 0, -1 },
+};
+
+static inline bool RgLightMap_Index_(const RgLightMap *self, int32_t x, int32_t y, RgSize *index) {
+	int64_t localX = (int64_t)x - self->originX, localY = (int64_t)y - self->originY;
+	if (localX < 0 || localY < 0 || localX >= (int64_t)self->width || localY >= (int64_t)self->height) return false;
+	*index = (RgSize)localY * self->width + (RgSize)localX;
+	return true;
+}
+
+static inline bool RgLightMap_IsOpaque_(const RgLightMap *self, int32_t x, int32_t y) {
+	RgSize index;
+	return !RgLightMap_Index_(self, x, y, &index) || self->opaque[index];
+}
+
+static inline uint8_t *RgLight_Intensity_(RgLight *light, int32_t x, int32_t y) {
+	return &light->intensity[(y - light->litY + RG_LIGHT_MAX_RADIUS) * RG_LIGHT_SIDE_ + (x - light->litX + RG_LIGHT_MAX_RADIUS)];
+}
+
+static inline void RgLightMap_Pack_(RgLightMap *self, RgSize index) {
+	const uint32_t *accum = &self->accum[index * 4];
+	RgPixel packed = 0;
+	for (int c = 0; c < 3; ++c) {
+		uint32_t value = accum[c] + ((self->ambient >> (16 - 8 * c)) & 0xFF);
+		packed |= (value > 0xFF ? 0xFF : value) << (16 - 8 * c);
+	}
+	self->packed[index] = packed;
+}
+
+/* adds (sign 1) or subtracts (sign -1) the cached contribution of `light`. the per-tile amounts
+   only depend on the cached intensity and litColor, so a subtraction exactly undoes its add. */
+static void RgLightMap_Apply_(RgLightMap *self, RgLight *light, int sign) {
+	int32_t radius = light->litRadius;
+	uint32_t channels[3] = {
+		(light->litColor >> 16) & 0xFF, (light->litColor >> 8) & 0xFF, light->litColor & 0xFF,
+	};
+
+	for (int32_t y = light->litY - radius; y <= light->litY + radius; ++y)
+	for (int32_t x = light->litX - radius; x <= light->litX + radius; ++x) {
+		uint32_t intensity = *RgLight_Intensity_(light, x, y);
+		RgSize index;
+		if (intensity == 0 || !RgLightMap_Index_(self, x, y, &index)) continue;
+
+		for (int c = 0; c < 3; ++c)
+			self->accum[index * 4 + c] += (uint32_t)(sign * (int32_t)((channels[c] * intensity + 127) / 255));
+		RgLightMap_Pack_(self, index);
+	}
+}
+
+/* recursive shadowcasting over one octant, rows `row` and further, between two slopes. */
+static void RgLightMap_CastOctant_(const RgLightMap *self, RgLight *light, int32_t row, float start, float end, const int m[4]) {
+	if (start < end) return;
+
+	int32_t radius = light->litRadius;
+	int32_t falloff = (radius + 1) * (radius + 1);
+	float newStart = 0.0f;
+
+	for (int32_t j = row; j <= radius; ++j) {
+		bool blocked = false;
+
+		for (int32_t dx = -j, dy = -j; dx <= 0; ++dx) {
+			float leftSlope = (dx - 0.5f) / (dy + 0.5f);
+			float rightSlope = (dx + 0.5f) / (dy - 0.5f);
+			if (start < rightSlope) continue;
+			if (end > leftSlope) break;
+
+			int32_t x = light->litX + dx * m[0] + dy * m[1];
+			int32_t y = light->litY + dx * m[2] + dy * m[3];
+			int32_t distance = dx * dx + dy * dy;
+			if (distance <= radius * radius)
+				*RgLight_Intensity_(light, x, y) = (uint8_t)(255 * (falloff - distance) / falloff);
+
+			bool opaque = RgLightMap_IsOpaque_(self, x, y);
+			if (blocked) {
+				if (opaque) {
+					newStart = rightSlope;
+					continue;
+				}
+				blocked = false;
+				start = newStart;
+			} else if (opaque && j < radius) {
+				blocked = true;
+				RgLightMap_CastOctant_(self, light, j + 1, start, leftSlope, m);
+				newStart = rightSlope;
+			}
+		}
+
+		if (blocked) break;
+	}
+}
+
+static void RgLightMap_Cast_(const RgLightMap *self, RgLight *light) {
+	RgMemFill(0, light->intensity, RG_LIGHT_AREA_);
+	*RgLight_Intensity_(light, light->litX, light->litY) = 255;
+
+	for (int octant = 0; octant < 8; ++octant)
+		RgLightMap_CastOctant_(self, light, 1, 1.0f, 0.0f, RgLight_Octants_[octant]);
+}
+
+static void RgLightMap_Reset_(RgLightMap *self) {
+	RgSize area = self->width * self->height;
+	RgMemFill(0, self->accum, sizeof(*self->accum) * 4 * area);
+	for (RgSize i = 0; i < area; ++i)
+		self->packed[i] = self->ambient;
+
+	for (RgSize i = 0; i < self->lightCount; ++i) {
+		self->lights[i]->lit = false;
+		self->lights[i]->dirty = true;
+	}
+}
+
+void RgLightMap_Init(RgLightMap *self, RgSize width, RgSize height, RgPixel ambient) {
+	RgMemFill(0, self, sizeof(*self));
+	self->width = width;
+	self->height = height;
+	self->ambient = ambient & 0xFFFFFF;
+
+	self->opaque = RgAllocArray(sizeof(*self->opaque), width * height);
+	self->accum = RgAllocArray(sizeof(*self->accum) * 4, width * height);
+	self->packed = RgAllocArray(sizeof(*self->packed), width * height);
+	if (self->opaque == NULL || self->accum == NULL || self->packed == NULL)
+		RgFail("Failed to allocate a %zux%zu light map.", width, height);
+
+	RgLightMap_Reset_(self);
+}
+
+void RgLightMap_DeInit(RgLightMap *self) {
+	for (RgSize i = 0; i < self->lightCount; ++i) {
+		RgDeAlloc(self->lights[i]->intensity);
+		self->lights[i]->intensity = NULL;
+	}
+	RgDeAlloc(self->lights);
+	RgDeAlloc(self->opaque);
+	RgDeAlloc(self->accum);
+	RgDeAlloc(self->packed);
+	RgMemFill(0, self, sizeof(*self));
+}
+
+void RgLightMap_SetOrigin(RgLightMap *self, int32_t x, int32_t y, RgWorld *world) {
+	self->originX = x;
+	self->originY = y;
+
+	for (RgSize ty = 0; ty < self->height; ++ty)
+	for (RgSize tx = 0; tx < self->width; ++tx) {
+		const RgTile *tile = RgWorld_GetTile(world, x + (int32_t)tx, y + (int32_t)ty);
+		self->opaque[ty * self->width + tx] = tile != NULL && (tile->flags & RG_TILE_FLAG_OPAQUE);
+	}
+
+	RgLightMap_Reset_(self);
+}
+
+void RgLightMap_Add(RgLightMap *self, RgLight *light) {
+	if (light->radius > RG_LIGHT_MAX_RADIUS) RgFail("Light radius %u is over the maximum of %d.", light->radius, RG_LIGHT_MAX_RADIUS);
+
+	if (self->lightCount == self->lightCapacity) {
+		RgSize capacity = Rg_Max(self->lightCapacity * 2, (RgSize)16);
+		RgLight **lights = RgAllocArray(sizeof(*lights), capacity);
+		if (lights == NULL) RgFail("Failed to grow the light list to %zu.", capacity);
+		if (self->lightCount != 0) __builtin_memcpy(lights, self->lights, sizeof(*lights) * self->lightCount);
+		RgDeAlloc(self->lights);
+		self->lights = lights;
+		self->lightCapacity = capacity;
+	}
+
+	light->intensity = RgAlloc(RG_LIGHT_AREA_);
+	if (light->intensity == NULL) RgFail("Failed to allocate light intensities.");
+	light->lit = false;
+	light->dirty = true;
+	light->index = self->lightCount;
+	self->lights[self->lightCount++] = light;
+}
+
+void RgLightMap_Remove(RgLightMap *self, RgLight *light) {
+	if (light->lit) RgLightMap_Apply_(self, light, -1);
+
+	RgLight *last = self->lights[--self->lightCount];
+	self->lights[light->index] = last;
+	last->index = light->index;
+
+	RgDeAlloc(light->intensity);
+	light->intensity = NULL;
+	light->lit = light->dirty = false;
+}
+
+void RgLightMap_Invalidate(RgLightMap *self, RgLight *light) {
+	// a light that isn't in the map would never be updated, so its change would be silently lost:
+	if (light->index >= self->lightCount || self->lights[light->index] != light) RgFail("Invalidated a light that isn't in the light map.");
+	if (light->radius > RG_LIGHT_MAX_RADIUS) RgFail("Light radius %u is over the maximum of %d.", light->radius, RG_LIGHT_MAX_RADIUS);
+	light->dirty = true;
+}
+
+void RgLightMap_SetOpaque(RgLightMap *self, int32_t x, int32_t y, bool opaque) {
+	RgSize index;
+	if (!RgLightMap_Index_(self, x, y, &index) || self->opaque[index] == opaque) return;
+	self->opaque[index] = opaque;
+
+	// a tile no ray of a light reached can't change what that light reaches:
+	for (RgSize i = 0; i < self->lightCount; ++i) {
+		RgLight *light = self->lights[i];
+		if (!light->lit || light->dirty) continue;
+		if (x < light->litX - light->litRadius || x > light->litX + light->litRadius) continue;
+		if (y < light->litY - light->litRadius || y > light->litY + light->litRadius) continue;
+		if (*RgLight_Intensity_(light, x, y) != 0) light->dirty = true;
+	}
+}
+
+void RgLightMap_SyncOpacity(RgLightMap *self, RgWorld *world) {
+	for (RgSize ty = 0; ty < self->height; ++ty)
+	for (RgSize tx = 0; tx < self->width; ++tx) {
+		int32_t x = self->originX + (int32_t)tx, y = self->originY + (int32_t)ty;
+		const RgTile *tile = RgWorld_GetTile(world, x, y);
+		bool opaque = tile != NULL && (tile->flags & RG_TILE_FLAG_OPAQUE);
+		if (self->opaque[ty * self->width + tx] != opaque) RgLightMap_SetOpaque(self, x, y, opaque);
+	}
+}
+
+RgSize RgLightMap_Update(RgLightMap *self) {
+	RgSize relit = 0;
+
+	for (RgSize i = 0; i < self->lightCount; ++i) {
+		RgLight *light = self->lights[i];
+		if (!light->dirty) continue;
+
+		if (light->lit) RgLightMap_Apply_(self, light, -1);
+		light->litX = light->x;
+		light->litY = light->y;
+		light->litRadius = light->radius;
+		light->litColor = light->color;
+		RgLightMap_Cast_(self, light);
+		RgLightMap_Apply_(self, light, 1);
+
+		light->lit = true;
+		light->dirty = false;
+		++relit;
+	}
+
+	return relit;
+}
+
+void RgLightMap_Read(const RgLightMap *self, int32_t x, int32_t y, RgSize width, RgSize height, RgPixel *out) {
+	for (RgSize ty = 0; ty < height; ++ty)
+	for (RgSize tx = 0; tx < width; ++tx) {
+		RgSize index;
+		bool inside = RgLightMap_Index_(self, x + (int32_t)tx, y + (int32_t)ty, &index);
+		out[ty * width + tx] = inside ? self->packed[index] : self->ambient;
+	}
+}
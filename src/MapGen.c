@@ -0,0 +1,371 @@
+#include <Rogue/MapGen.h>
+#include <Rogue/Random.h>
+#include <Rogue/Core.h>
+
+/* stream ids for RgRandom_Key, one per generator stage. */
+enum {
+	RG_MAPGEN_STREAM_HEIGHT_ = 1,
+	RG_MAPGEN_STREAM_DETAIL_,
+	RG_MAPGEN_STREAM_ROUGHNESS_,
+	RG_MAPGEN_STREAM_MOISTURE_,
+	RG_MAPGEN_STREAM_REGION_,
+	RG_MAPGEN_STREAM_CAVES_,
+	RG_MAPGEN_STREAM_ROOMS_,
+};
+
+#define RG_MAPGEN_CAVE_STEPS_ 4
+#define RG_MAPGEN_CAVE_FILL_ 45 /* percent of cave cells that start as wall. */
+#define RG_MAPGEN_CAVE_SIDE_ (RG_CHUNK_SIZE + 2 * RG_MAPGEN_CAVE_STEPS_)
+#define RG_MAPGEN_ROOM_MIN_LEAF_ 10
+
+static const RgTile RgMapGen_Floor_ = { .glyph = '.', .color = 1 };
+static const RgTile RgMapGen_Wall_ = { .glyph = '#', .color = 1, .flags = RG_TILE_FLAG_OPAQUE | RG_TILE_FLAG_SOLID };
+static const RgTile RgMapGen_Water_ = { .glyph = '~', .color = 3, .flags = RG_TILE_FLAG_SOLID };
+static const RgTile RgMapGen_Tree_ = { .glyph = '^', .color = 2, .flags = RG_TILE_FLAG_OPAQUE };
+
+static inline uint64_t RgMapGen_Pack_(int64_t x, int64_t y) {
+	return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+}
+
+/* floor(v / 2^shift) without relying on how signed right shifts round. */
+static inline int64_t RgMapGen_FloorShift_(int64_t v, int shift) {
+	return v >= 0 ? v >> shift : -((-v - 1) >> shift) - 1;
+}
+
+/* 16-bit hermite smoothstep on a 16-bit fraction. */
+static inline int64_t RgMapGen_Smooth_(int64_t t) {
+	return (int64_t)(((uint64_t)t * (uint64_t)t * (uint64_t)(3 * 65536 - 2 * t)) >> 32);
+}
+
+static inline int64_t RgMapGen_Lerp_(int64_t a, int64_t b, int64_t t) {
+	// division truncates the same way everywhere, unlike a right shift of a negative number.
+	return a + (b - a) * t / 65536;
+}
+
+/*
+ * value noise in [0, 65535] with lattice cells of 2^shift tiles. integer-only, so results don't
+ * depend on float contraction or the target's FPU.
+ */
+static int64_t RgMapGen_Noise_(uint64_t key, int64_t x, int64_t y, int shift) {
+	int64_t cx = RgMapGen_FloorShift_(x, shift);
+	int64_t cy = RgMapGen_FloorShift_(y, shift);
+	int64_t sx = RgMapGen_Smooth_((x - cx * (1 << shift)) << (16 - shift));
+	int64_t sy = RgMapGen_Smooth_((y - cy * (1 << shift)) << (16 - shift));
+
+	int64_t v00 = RgRandom_Hash(key, RgMapGen_Pack_(cx, cy)) >> 48;
+	int64_t v10 = RgRandom_Hash(key, RgMapGen_Pack_(cx + 1, cy)) >> 48;
+	int64_t v01 = RgRandom_Hash(key, RgMapGen_Pack_(cx, cy + 1)) >> 48;
+	int64_t v11 = RgRandom_Hash(key, RgMapGen_Pack_(cx + 1, cy + 1)) >> 48;
+
+	return RgMapGen_Lerp_(RgMapGen_Lerp_(v00, v10, sx), RgMapGen_Lerp_(v01, v11, sx), sy);
+}
+
+static inline uint64_t RgMapGen_StageKey_(uint64_t seed, uint64_t stream) {
+	return RgRandom_Key(seed, 0, 0, stream);
+}
+
+RgMapGenRegion RgMapGen_GetRegion(uint64_t seed, int32_t x, int32_t y) {
+	int64_t value = RgMapGen_Noise_(RgMapGen_StageKey_(seed, RG_MAPGEN_STREAM_REGION_), x, y, 2);
+	if (value < 24000) return RG_MAPGEN_REGION_CAVES;
+	if (value > 42000) return RG_MAPGEN_REGION_ROOMS;
+	return RG_MAPGEN_REGION_TERRAIN;
+}
+
+static void RgMapGen_Terrain_(uint64_t seed, int64_t originX, int64_t originY, RgChunk *chunk) {
+	uint64_t heightKey = RgMapGen_StageKey_(seed, RG_MAPGEN_STREAM_HEIGHT_);
+	uint64_t detailKey = RgMapGen_StageKey_(seed, RG_MAPGEN_STREAM_DETAIL_);
+	uint64_t roughnessKey = RgMapGen_StageKey_(seed, RG_MAPGEN_STREAM_ROUGHNESS_);
+	uint64_t moistureKey = RgMapGen_StageKey_(seed, RG_MAPGEN_STREAM_MOISTURE_);
+
+	for (RgInt ty = 0; ty < RG_CHUNK_SIZE; ++ty)
+	for (RgInt tx = 0; tx < RG_CHUNK_SIZE; ++tx) {
+		int64_t x = originX + tx, y = originY + ty;
+
+		// three octaves, weighted 4:2:1:
+		int64_t height = (
+			RgMapGen_Noise_(heightKey, x, y, 5) * 4
+			+ RgMapGen_Noise_(detailKey, x, y, 3) * 2
+			+ RgMapGen_Noise_(roughnessKey, x, y, 2)
+		) / 7;
+		int64_t moisture = RgMapGen_Noise_(moistureKey, x, y, 4);
+
+		RgTile tile = RgMapGen_Floor_;
+		if (height < 20000) tile = RgMapGen_Water_;
+		else if (height > 46000) tile = RgMapGen_Wall_;
+		else if (moisture > 44000) tile = RgMapGen_Tree_;
+
+		chunk->tiles[ty * RG_CHUNK_SIZE + tx] = tile;
+	}
+}
+
+/*
+ * cellular-automata caves. the initial fill is hashed from world coordinates, and the automaton
+ * runs on the chunk plus one tile of margin per step, so the interior matches what a single
+ * automaton over the whole world would produce and caves continue across chunk borders.
+ */
+static void RgMapGen_Caves_(uint64_t seed, int64_t originX, int64_t originY, RgChunk *chunk) {
+	enum { SIDE = RG_MAPGEN_CAVE_SIDE_, MARGIN = RG_MAPGEN_CAVE_STEPS_ };
+	static_assert(SIDE * SIDE <= 4096, "cave grids live on the stack");
+
+	uint64_t key = RgMapGen_StageKey_(seed, RG_MAPGEN_STREAM_CAVES_);
+	uint8_t grids[2][SIDE * SIDE];
+	uint8_t *cur = grids[0], *next = grids[1];
+
+	for (RgInt y = 0; y < SIDE; ++y)
+	for (RgInt x = 0; x < SIDE; ++x) {
+		uint64_t r = RgRandom_Hash(key, RgMapGen_Pack_(originX + x - MARGIN, originY + y - MARGIN));
+		cur[y * SIDE + x] = (r >> 32) % 100 < RG_MAPGEN_CAVE_FILL_;
+	}
+
+	for (RgInt step = 0; step < RG_MAPGEN_CAVE_STEPS_; ++step) {
+		// only cells whose whole neighborhood is still exact get updated; the rest go stale.
+		for (RgInt y = step + 1; y < SIDE - step - 1; ++y)
+		for (RgInt x = step + 1; x < SIDE - step - 1; ++x) {
+			RgInt walls = 0;
+			for (RgInt dy = -1; dy <= 1; ++dy)
+			for (RgInt dx = -1; dx <= 1; ++dx)
+				walls += cur[(y + dy) * SIDE + (x + dx)];
+			next[y * SIDE + x] = walls >= 5;
+		}
+
+		uint8_t *swap = cur; cur = next; next = swap;
+	}
+
+	for (RgInt y = 0; y < RG_CHUNK_SIZE; ++y)
+	for (RgInt x = 0; x < RG_CHUNK_SIZE; ++x)
+		chunk->tiles[y * RG_CHUNK_SIZE + x] = cur[(y + MARGIN) * SIDE + (x + MARGIN)] ? RgMapGen_Wall_ : RgMapGen_Floor_;
+}
+
+static void RgMapGen_Carve_(RgChunk *chunk, RgInt x0, RgInt y0, RgInt x1, RgInt y1) {
+	for (RgInt y = Rg_Min(y0, y1); y <= Rg_Max(y0, y1); ++y)
+	for (RgInt x = Rg_Min(x0, x1); x <= Rg_Max(x0, x1); ++x)
+		chunk->tiles[y * RG_CHUNK_SIZE + x] = RgMapGen_Floor_;
+}
+
+/* L-shaped corridor: horizontal first, then vertical. */
+static void RgMapGen_Corridor_(RgChunk *chunk, RgInt x0, RgInt y0, RgInt x1, RgInt y1) {
+	RgMapGen_Carve_(chunk, x0, y0, x1, y0);
+	RgMapGen_Carve_(chunk, x1, y0, x1, y1);
+}
+
+/* splits the leaf along its longer side until it is small enough, then carves a room into it.
+   returns the center of one of the rooms below, for the parent to connect to. */
+static void RgMapGen_SplitRooms_(RgChunk *chunk, RgCounterRng *rng, RgInt x, RgInt y, RgInt w, RgInt h, RgInt *cx, RgInt *cy) {
+	bool splitX = w >= h;
+	RgInt length = splitX ? w : h;
+
+	if (length < 2 * RG_MAPGEN_ROOM_MIN_LEAF_) {
+		RgInt rw = 3 + RgCounterRng_Below(rng, w - 4);
+		RgInt rh = 3 + RgCounterRng_Below(rng, h - 4);
+		RgInt rx = x + 1 + RgCounterRng_Below(rng, w - rw - 1);
+		RgInt ry = y + 1 + RgCounterRng_Below(rng, h - rh - 1);
+		RgMapGen_Carve_(chunk, rx, ry, rx + rw - 1, ry + rh - 1);
+		*cx = rx + rw / 2;
+		*cy = ry + rh / 2;
+		return;
+	}
+
+	RgInt split = RG_MAPGEN_ROOM_MIN_LEAF_ + RgCounterRng_Below(rng, length - 2 * RG_MAPGEN_ROOM_MIN_LEAF_ + 1);
+	RgInt ax, ay, bx, by;
+	if (splitX) {
+		RgMapGen_SplitRooms_(chunk, rng, x, y, split, h, &ax, &ay);
+		RgMapGen_SplitRooms_(chunk, rng, x + split, y, w - split, h, &bx, &by);
+	} else {
+		RgMapGen_SplitRooms_(chunk, rng, x, y, w, split, &ax, &ay);
+		RgMapGen_SplitRooms_(chunk, rng, x, y + split, w, h - split, &bx, &by);
+	}
+
+	RgMapGen_Corridor_(chunk, ax, ay, bx, by);
+	*cx = ax;
+	*cy = ay;
+}
+
+/* BSP rooms. every rooms chunk also runs a corridor to the middle of each edge, so adjacent
+   rooms chunks always connect. */
+static void RgMapGen_Rooms_(uint64_t seed, int32_t chunkX, int32_t chunkY, RgChunk *chunk) {
+	for (RgSize i = 0; i < RG_CHUNK_AREA; ++i)
+		chunk->tiles[i] = RgMapGen_Wall_;
+
+	RgCounterRng rng;
+	RgCounterRng_Init(&rng, RgRandom_Key(seed, chunkX, chunkY, RG_MAPGEN_STREAM_ROOMS_));
+
+	RgInt cx, cy;
+	RgMapGen_SplitRooms_(chunk, &rng, 0, 0, RG_CHUNK_SIZE, RG_CHUNK_SIZE, &cx, &cy);
+
+	RgInt mid = RG_CHUNK_SIZE / 2, last = RG_CHUNK_SIZE - 1;
+	RgMapGen_Corridor_(chunk, cx, cy, mid, 0);
+	RgMapGen_Corridor_(chunk, cx, cy, mid, last);
+	RgMapGen_Corridor_(chunk, cx, cy, 0, mid);
+	RgMapGen_Corridor_(chunk, cx, cy, last, mid);
+}
+
+void RgMapGen_GenerateChunk(uint64_t seed, int32_t x, int32_t y, RgChunk *chunk) {
+	RgMemFill(0, chunk, sizeof(*chunk));
+	chunk->x = x;
+	chunk->y = y;
+
+	int64_t originX = (int64_t)x * RG_CHUNK_SIZE;
+	int64_t originY = (int64_t)y * RG_CHUNK_SIZE;
+
+	switch (RgMapGen_GetRegion(seed, x, y)) {
+	case RG_MAPGEN_REGION_TERRAIN: RgMapGen_Terrain_(seed, originX, originY, chunk); break;
+	case RG_MAPGEN_REGION_CAVES: RgMapGen_Caves_(seed, originX, originY, chunk); break;
+	case RG_MAPGEN_REGION_ROOMS: RgMapGen_Rooms_(seed, x, y, chunk); break;
+	}
+}
+
+typedef struct RgMapGenTask_ {
+	RgMapStreamer *streamer;
+	RgChunk chunk;
+} RgMapGenTask_;
+
+/* packed coordinates of the one chunk that can't be requested, used to mark empty slots. */
+#define RG_MAPSTREAMER_EMPTY_ 0x8000000080000000ull
+
+static inline RgSize RgMapStreamer_Slot_(uint64_t key, RgSize capacity) {
+	return RgRandom_Mix(key) & (capacity - 1);
+}
+
+static void RgMapStreamer_Insert_(uint64_t *table, RgSize capacity, uint64_t key) {
+	RgSize slot = RgMapStreamer_Slot_(key, capacity);
+	while (table[slot] != RG_MAPSTREAMER_EMPTY_) slot = (slot + 1) & (capacity - 1);
+	table[slot] = key;
+}
+
+static uint64_t *RgMapStreamer_AllocTable_(RgSize capacity) {
+	uint64_t *table = RgAllocArray(sizeof(*table), capacity);
+	if (table == NULL) RgFail("Failed to allocate a chunk request table of %zu slots.", capacity);
+	for (RgSize i = 0; i < capacity; ++i) table[i] = RG_MAPSTREAMER_EMPTY_;
+	return table;
+}
+
+/* adds `key` to the requested set. returns false if it was already there. */
+static bool RgMapStreamer_MarkRequested_(RgMapStreamer *self, uint64_t key) {
+	for (RgSize slot = RgMapStreamer_Slot_(key, self->requestedCapacity);; slot = (slot + 1) & (self->requestedCapacity - 1)) {
+		if (self->requested[slot] == key) return false;
+		if (self->requested[slot] == RG_MAPSTREAMER_EMPTY_) break;
+	}
+
+	if ((self->requestedCount + 1) * 2 > self->requestedCapacity) {
+		RgSize capacity = self->requestedCapacity * 2;
+		uint64_t *table = RgMapStreamer_AllocTable_(capacity);
+		for (RgSize i = 0; i < self->requestedCapacity; ++i)
+			if (self->requested[i] != RG_MAPSTREAMER_EMPTY_) RgMapStreamer_Insert_(table, capacity, self->requested[i]);
+		RgDeAlloc(self->requested);
+		self->requested = table;
+		self->requestedCapacity = capacity;
+	}
+
+	RgMapStreamer_Insert_(self->requested, self->requestedCapacity, key);
+	++self->requestedCount;
+	return true;
+}
+
+static void RgMapStreamer_Job_(void *data) {
+	RgMapGenTask_ *task = data;
+	RgMapStreamer *self = task->streamer;
+	RgMapGen_GenerateChunk(self->seed, task->chunk.x, task->chunk.y, &task->chunk);
+
+	mtx_lock(&self->lock);
+	if (self->doneCount == self->doneCapacity) {
+		RgSize capacity = Rg_Max(self->doneCapacity * 2, (RgSize)64);
+		RgMapGenTask_ **done = RgAllocArray(sizeof(*done), capacity);
+		if (done == NULL) RgFail("Failed to grow the finished chunk list to %zu.", capacity);
+		if (self->doneCount != 0) __builtin_memcpy(done, self->done, sizeof(*done) * self->doneCount);
+		RgDeAlloc(self->done);
+		self->done = done;
+		self->doneCapacity = capacity;
+	}
+	self->done[self->doneCount++] = task;
+	mtx_unlock(&self->lock);
+}
+
+void RgMapStreamer_Init(RgMapStreamer *self, RgJobSystem *jobs, uint64_t seed) {
+	self->jobs = jobs;
+	self->seed = seed;
+	self->requestedCapacity = 256;
+	self->requestedCount = 0;
+	self->requested = RgMapStreamer_AllocTable_(self->requestedCapacity);
+	atomic_init(&self->pending.pending, 0);
+	if (mtx_init(&self->lock, mtx_plain) != thrd_success) RgFail("Failed to create map streamer lock.");
+	self->done = NULL;
+	self->doneCount = self->doneCapacity = 0;
+}
+
+void RgMapStreamer_DeInit(RgMapStreamer *self) {
+	RgJobSystem_Wait(self->jobs, &self->pending);
+
+	for (RgSize i = 0; i < self->doneCount; ++i)
+		RgDeAlloc(self->done[i]);
+	RgDeAlloc(self->done);
+	RgDeAlloc(self->requested);
+	mtx_destroy(&self->lock);
+
+	self->done = NULL;
+	self->requested = NULL;
+	self->doneCount = self->doneCapacity = 0;
+	self->requestedCount = self->requestedCapacity = 0;
+}
+
+void RgMapStreamer_Request(RgMapStreamer *self, int32_t x, int32_t y) {
+	uint64_t key = RgMapGen_Pack_(x, y);
+	if (key == RG_MAPSTREAMER_EMPTY_ || !RgMapStreamer_MarkRequested_(self, key)) return;
+
+	RgMapGenTask_ *task = RgAlloc(sizeof(*task));
+	if (task == NULL) RgFail("Failed to allocate a map generation task.");
+	task->streamer = self;
+	task->chunk.x = x;
+	task->chunk.y = y;
+	RgJobSystem_Spawn(self->jobs, &RgMapStreamer_Job_, task, &self->pending);
+}
+
+void RgMapStreamer_RequestAround(RgMapStreamer *self, int32_t x, int32_t y, int32_t radius) {
+	for (int32_t ring = 0; ring <= radius; ++ring)
+	for (int32_t dy = -ring; dy <= ring; ++dy)
+	for (int32_t dx = -ring; dx <= ring; ++dx) {
+		// only the border of each ring, the inside was requested by the smaller rings:
+		if (dx != -ring && dx != ring && dy != -ring && dy != ring) continue;
+		RgMapStreamer_Request(self, x + dx, y + dy);
+	}
+}
+
+RgSize RgMapStreamer_Drain(RgMapStreamer *self, RgWorld *world, RgSize maxChunks) {
+	// with no other workers, nothing would ever pick up the jobs, so make some progress here:
+	if (self->jobs->workerCount == 1) RgJobSystem_RunOne(self->jobs);
+
+	RgMapGenTask_ *tasks[64];
+	RgSize total = 0;
+
+	while (total < maxChunks) {
+		mtx_lock(&self->lock);
+		RgSize count = Rg_Min(Rg_Min(self->doneCount, maxChunks - total), sizeof(tasks) / sizeof(*tasks));
+		self->doneCount -= count;
+		if (count != 0) __builtin_memcpy(tasks, self->done + self->doneCount, sizeof(*tasks) * count);
+		mtx_unlock(&self->lock);
+
+		if (count == 0) break;
+
+		for (RgSize i = 0; i < count; ++i) {
+			RgChunk *chunk = RgWorld_AddChunk(world, tasks[i]->chunk.x, tasks[i]->chunk.y);
+			__builtin_memcpy(chunk, &tasks[i]->chunk, sizeof(*chunk));
+			RgDeAlloc(tasks[i]);
+		}
+		total += count;
+	}
+
+	return total;
+}
+
+bool RgMapStreamer_IsBusy(RgMapStreamer *self) {
+	if (atomic_load(&self->pending.pending) != 0) return true;
+
+	mtx_lock(&self->lock);
+	bool busy = self->doneCount != 0;
+	mtx_unlock(&self->lock);
+	return busy;
+}
+
+void RgMapStreamer_Flush(RgMapStreamer *self, RgWorld *world) {
+	RgJobSystem_Wait(self->jobs, &self->pending);
+	RgMapStreamer_Drain(self, world, SIZE_MAX);
+}
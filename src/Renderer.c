@@ -1,5 +1,28 @@
 #include <Rogue/Renderer.h>
 #include <Rogue/Core.h>
+#include <threads.h>
+
+extern const uint8_t font8x8_basic[128][8];
+
+static uint64_t RgFont_BuiltinRows_[128 * 8];
+static once_flag RgFont_BuiltinOnce_ = ONCE_FLAG_INIT;
+
+static void RgFont_ExpandBuiltin_(void) {
+	// font8x8 already keeps the leftmost pixel of a row in bit 0:
+	for (RgSize i = 0; i < 128 * 8; ++i)
+		RgFont_BuiltinRows_[i] = font8x8_basic[i / 8][i % 8];
+}
+
+void RgFont_InitBuiltin(RgFont *self, RgSize cellWidth, RgSize cellHeight) {
+	call_once(&RgFont_BuiltinOnce_, &RgFont_ExpandBuiltin_);
+	*self = (RgFont){
+		.symbolWidth = cellWidth, .symbolHeight = cellHeight,
+		.fontAsciiMap = NULL,
+		.symbolCount = 128,
+		.symbolRows = RgFont_BuiltinRows_,
+		.glyphWidth = 8, .glyphHeight = 8,
+	};
+}
 
 void RgRenderer_Init(RgRenderer *self, RgWindow *window, RgSize width, RgSize height, RgFont *font) {
 	self->width = width;
@@ -10,78 +33,119 @@ void RgRenderer_Init(RgRenderer *self, RgWindow *window, RgSize width, RgSize he
 	self->borderColor = 0xFFFFFF;
 	self->screenOffset.x = 32;
 	self->screenOffset.y = 32;
+	self->light = NULL;
 	self->buffer = RgAllocArray(sizeof(*self->buffer), self->width * self->height);
+	self->colors = RgAllocArray(sizeof(*self->colors), self->width * self->height);
 }
 
 void RgRenderer_DeInit(RgRenderer *self) {
 	RgDeAlloc(self->buffer);
+	RgDeAlloc(self->colors);
+}
+
+typedef uint8_t RgU8x16_ [[gnu::vector_size(16)]];
+typedef uint16_t RgU16x16_ [[gnu::vector_size(32)]];
+
+/* colors[i] = colors[i] * light[i] / 255 per channel, rounded. four pixels per step. */
+static void RgRenderer_ApplyLight_(RgPixel *colors, const RgPixel *light, RgSize count) {
+	RgSize i = 0;
+	for (; i + 4 <= count; i += 4) {
+		RgU8x16_ color, lightBytes;
+		__builtin_memcpy(&color, colors + i, sizeof(color));
+		__builtin_memcpy(&lightBytes, light + i, sizeof(lightBytes));
+
+		// (p + (p >> 8)) >> 8 with p = c * l + 128 is c * l / 255 rounded, for all 8-bit c and l:
+		RgU16x16_ product = __builtin_convertvector(color, RgU16x16_) * __builtin_convertvector(lightBytes, RgU16x16_) + 128;
+		color = __builtin_convertvector((product + (product >> 8)) >> 8, RgU8x16_);
+		__builtin_memcpy(colors + i, &color, sizeof(color));
+	}
+
+	for (; i < count; ++i) {
+		RgPixel lit = 0;
+		for (int shift = 0; shift < 32; shift += 8) {
+			uint32_t product = ((colors[i] >> shift) & 0xFF) * ((light[i] >> shift) & 0xFF) + 128;
+			lit |= ((product + (product >> 8)) >> 8) << shift;
+		}
+		colors[i] = lit;
+	}
 }
 
 void RgRenderer_Refresh(RgRenderer *self) {
+	RgSize count = self->width * self->height;
+	for (RgSize i = 0; i < count; ++i)
+		self->colors[i] = self->palette[self->buffer[i].color];
+	if (self->light != NULL) RgRenderer_ApplyLight_(self->colors, self->light, count);
+
 	for (RgInt sy = 0; sy < self->height; ++sy) {
 		for (RgInt sx = 0; sx < self->width; ++sx) {
 			RgSymbol symbol = self->buffer[sy * self->width + sx];
-			uint32_t col = self->palette[symbol.color];
+			uint32_t col = self->colors[sy * self->width + sx];
 
-			const uint8_t *bitmap = NULL;
-			if (self->font->fontAsciiMap != NULL) { 
-				/* bitmap = ... */
-			} else {
-				bitmap = &self->font->symbolBitmaps[symbol.value * 8];
-			}
+			const RgFont *font = self->font;
+			RgSize glyph = (uint8_t)symbol.value;
+			if (font->fontAsciiMap != NULL) glyph = font->fontAsciiMap[glyph];
+			// symbols without a glyph still get their cell cleared, as empty rows:
+			const uint64_t *rows = glyph < font->symbolCount ? &font->symbolRows[glyph * font->glyphHeight] : NULL;
 
-			RgInt offsetX = sx * (RgInt)self->font->symbolWidth
-				+ self->screenOffset.x + (RgInt)(self->font->symbolWidth - 8) / 2;
+			RgInt offsetX = sx * (RgInt)font->symbolWidth
+				+ self->screenOffset.x + ((RgInt)font->symbolWidth - (RgInt)font->glyphWidth) / 2;
 
-			RgInt offsetY = sy * (RgInt)self->font->symbolHeight
-				+ self->screenOffset.y + (RgInt)(self->font->symbolHeight - 8) / 2;
+			RgInt offsetY = sy * (RgInt)font->symbolHeight
+				+ self->screenOffset.y + ((RgInt)font->symbolHeight - (RgInt)font->glyphHeight) / 2;
 
 			if (offsetX >= self->window->bufferWidth || offsetY >= self->window->bufferHeight || offsetX < 0 || offsetY < 0)
 				continue;
 
 			RgSize offset = offsetX + offsetY * self->window->bufferWidth;
+			RgSize width = Rg_Min(font->glyphWidth, self->window->bufferWidth - offsetX);
+			RgSize height = Rg_Min(font->glyphHeight, self->window->bufferHeight - offsetY);
 
-			for (RgSize y = 0; y < 8; y++) {
-				if (offsetY + y >= self->window->bufferHeight) break;
-        for (RgSize x = 0; x < 8; x++) {
-					if (offsetX + x >= self->window->bufferWidth) break;
-					self->window->buffer[offset + x + y * self->window->bufferWidth]
-						= (bitmap[y] & (1 << x)) ? col : 0;
-        }
-    	}
+			for (RgSize y = 0; y < height; y++) {
+				RgPixel *row = &self->window->buffer[offset + y * self->window->bufferWidth];
+				uint64_t rowBits = rows != NULL ? rows[y] : 0;
+				for (RgSize x = 0; x < width; x++)
+					row[x] = (rowBits >> x) & 1 ? col : 0;
+			}
 		}
 	}
 
-	if (self->drawBorder) {
-		RgSize screenWidth = self->width * self->font->symbolWidth;
-		RgSize screenHeight = self->width * self->font->symbolHeight;
-		RgInt offset;
-		
-		// draw the upper horizontal line:
-		offset = (self->screenOffset.y - 1) * (RgInt)self->window->bufferWidth + (self->screenOffset.x - 1);
-		if (offset >= 0 && offset <= self->window->bufferWidth * self->window->bufferHeight) {
-			for (RgInt pos = offset; pos < offset + Rg_Min(screenWidth + 2, self->window->bufferWidth); ++pos) {
-				self->window->buffer[pos] = self->borderColor;
-			}
-		}
+	if (self->drawBorder) RgRenderer_DrawBorder(self);
+}
 
-		offset = Rg_Max(self->screenOffset.y, 0) * (RgInt)self->window->bufferWidth + (self->screenOffset.x - 1);
+void RgRenderer_Clear(RgRenderer *self, char value, uint8_t color) {
+	for (RgSize i = 0; i < self->width * self->height; ++i)
+		self->buffer[i] = (RgSymbol){ .value = value, .color = color };
+}
 
-		// draw the vertical lines:
-		for (
-			RgSize pos = offset;
-			pos < offset + self->window->bufferWidth * Rg_Min(screenHeight - 1, self->window->bufferHeight);
-			pos += self->window->bufferWidth
-		) {
+void RgRenderer_DrawBorder(RgRenderer *self) {
+	RgSize screenWidth = self->width * self->font->symbolWidth;
+	RgSize screenHeight = self->height * self->font->symbolHeight;
+	RgInt offset;
+	
+	// draw the upper horizontal line:
+	offset = (self->screenOffset.y - 1) * (RgInt)self->window->bufferWidth + (self->screenOffset.x - 1);
+	if (offset >= 0 && offset <= self->window->bufferWidth * self->window->bufferHeight) {
+		for (RgInt pos = offset; pos < offset + Rg_Min(screenWidth + 2, self->window->bufferWidth); ++pos) {
 			self->window->buffer[pos] = self->borderColor;
-			self->window->buffer[pos + screenWidth + 1] = self->borderColor;
 		}
+	}
 
-		// draw the bottom horizontal line:
-		offset = (self->screenOffset.y + screenHeight - 1) * self->window->bufferWidth + (self->screenOffset.x - 1);
-		if (offset >= 0 && offset <= self->window->bufferWidth * self->window->bufferHeight - screenWidth - 2) {
-			for (RgSize pos = offset; pos < offset + screenWidth + 2; ++pos)
-				self->window->buffer[pos] = self->borderColor;
-		}
+	offset = Rg_Max(self->screenOffset.y, 0) * (RgInt)self->window->bufferWidth + (self->screenOffset.x - 1);
+
+	// draw the vertical lines:
+	for (
+		RgSize pos = offset;
+		pos < offset + self->window->bufferWidth * Rg_Min(screenHeight - 1, self->window->bufferHeight);
+		pos += self->window->bufferWidth
+	) {
+		self->window->buffer[pos] = self->borderColor;
+		self->window->buffer[pos + screenWidth + 1] = self->borderColor;
+	}
+
+	// draw the bottom horizontal line:
+	offset = (self->screenOffset.y + screenHeight - 1) * self->window->bufferWidth + (self->screenOffset.x - 1);
+	if (offset >= 0 && offset <= self->window->bufferWidth * self->window->bufferHeight - screenWidth - 2) {
+		for (RgSize pos = offset; pos < offset + screenWidth + 2; ++pos)
+			self->window->buffer[pos] = self->borderColor;
 	}
 }
@@ -0,0 +1,345 @@
+#define _POSIX_C_SOURCE 200809L
+#include <Rogue/Snapshot.h>
+#include <Rogue/Core.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+
+/* records are used in place, so the host has to share the file's byte order. */
+#define RG_SNAPSHOT_NATIVE_ (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+
+static const uint8_t RgSnapshot_Padding_[RG_SNAPSHOT_ALIGN] = {0};
+
+static inline uint64_t RgSnapshot_Align_(uint64_t offset) {
+	return (offset + RG_SNAPSHOT_ALIGN - 1) & ~(uint64_t)(RG_SNAPSHOT_ALIGN - 1);
+}
+
+static inline uint64_t RgSnapshot_HeaderChecksum_(const RgSnapshotHeader *header) {
+	return RgHash(header, offsetof(RgSnapshotHeader, headerChecksum), RG_SNAPSHOT_MAGIC);
+}
+
+static void RgSnapshot_FillSection_(RgSnapshotSection *section, uint64_t *offset, const void *data, RgSize count, RgSize recordSize) {
+	section->offset = RgSnapshot_Align_(*offset);
+	section->count = count;
+	section->size = count * recordSize;
+	section->checksum = RgHash(data, section->size, RG_SNAPSHOT_MAGIC);
+	*offset = section->offset + section->size;
+}
+
+static bool RgSnapshot_WriteAll_(int fd, struct iovec *iov, int iovCount) {
+	while (iovCount > 0) {
+		ssize_t written = writev(fd, iov, iovCount);
+		if (written < 0) {
+			if (errno == EINTR) continue;
+			return false;
+		}
+
+		// skip fully written buffers, then trim the partially written one:
+		while (iovCount > 0 && (size_t)written >= iov->iov_len) {
+			written -= iov->iov_len;
+			++iov;
+			--iovCount;
+		}
+
+		if (iovCount > 0) {
+			iov->iov_base = (uint8_t *)iov->iov_base + written;
+			iov->iov_len -= written;
+		}
+	}
+	return true;
+}
+
+/* steps of writing a snapshot, as reported by RgSnapshot_Write_ and a forked writer's exit status. */
+typedef enum : uint8_t {
+	RG_SNAPSHOT_STEP_DONE_ = 0,
+	RG_SNAPSHOT_STEP_CREATE_,
+	RG_SNAPSHOT_STEP_WRITE_,
+	RG_SNAPSHOT_STEP_SYNC_,
+	RG_SNAPSHOT_STEP_RENAME_,
+	RG_SNAPSHOT_STEP_SYNC_DIR_,
+	RG_SNAPSHOT_STEP_COUNT_,
+} RgSnapshotStep_;
+
+static const char *const RgSnapshot_StepNames_[RG_SNAPSHOT_STEP_COUNT_] = {
+	[RG_SNAPSHOT_STEP_CREATE_] = "create",
+	[RG_SNAPSHOT_STEP_WRITE_] = "write",
+	[RG_SNAPSHOT_STEP_SYNC_] = "flush",
+	[RG_SNAPSHOT_STEP_RENAME_] = "rename",
+	[RG_SNAPSHOT_STEP_SYNC_DIR_] = "flush the directory of",
+};
+
+/* every path a save touches, built up front so the write itself needs no formatting. */
+typedef struct {
+	const char *path;
+	char tempPath[4096];
+	char dirPath[4096];
+} RgSnapshotPaths_;
+
+static bool RgSnapshot_MakePaths_(RgSnapshotPaths_ *paths, const char *path) {
+	paths->path = path;
+	if (snprintf(paths->tempPath, sizeof(paths->tempPath), "%s.tmp", path) >= (int)sizeof(paths->tempPath)) {
+		RgLogError("Snapshot path is too long: %s", path);
+		return false;
+	}
+
+	const char *slash = strrchr(path, '/');
+	if (slash == NULL) {
+		strcpy(paths->dirPath, ".");
+	} else {
+		RgSize length = slash == path ? 1 : (RgSize)(slash - path);
+		memcpy(paths->dirPath, path, length);
+		paths->dirPath[length] = '\0';
+	}
+	return true;
+}
+
+/*
+ * writes `world` next to the destination, flushes it to disk, renames it over the destination and
+ * flushes the directory, so a crash or power loss leaves either the old or the new save, never a
+ * torn one. only makes system calls, so a child forked from a threaded process can run it.
+ * returns the step that failed, with errno set by it.
+ */
+static RgSnapshotStep_ RgSnapshot_Write_(const RgWorld *world, const RgSnapshotPaths_ *paths) {
+	RgSnapshotHeader header = {
+		.magic = RG_SNAPSHOT_MAGIC,
+		.version = RG_SNAPSHOT_VERSION,
+		.headerSize = sizeof(RgSnapshotHeader),
+		.chunkSize = RG_CHUNK_SIZE,
+		.chunkRecordSize = sizeof(RgChunk),
+		.entityRecordSize = sizeof(RgEntity),
+		.rng = world->rng,
+	};
+
+	uint64_t offset = sizeof(header);
+	RgSnapshot_FillSection_(&header.chunks, &offset, world->chunks, world->chunkCount, sizeof(RgChunk));
+	RgSnapshot_FillSection_(&header.entities, &offset, world->entities, world->entityCount, sizeof(RgEntity));
+	header.fileSize = offset;
+	header.headerChecksum = RgSnapshot_HeaderChecksum_(&header);
+
+	struct iovec iov[] = {
+		{ &header, sizeof(header) },
+		{ (void *)RgSnapshot_Padding_, header.chunks.offset - sizeof(header) },
+		{ world->chunks, header.chunks.size },
+		{ (void *)RgSnapshot_Padding_, header.entities.offset - (header.chunks.offset + header.chunks.size) },
+		{ world->entities, header.entities.size },
+	};
+
+	int fd = open(paths->tempPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) return RG_SNAPSHOT_STEP_CREATE_;
+
+	RgSnapshotStep_ failed = RG_SNAPSHOT_STEP_DONE_;
+	if (!RgSnapshot_WriteAll_(fd, iov, sizeof(iov) / sizeof(*iov))) failed = RG_SNAPSHOT_STEP_WRITE_;
+	// the data has to be on disk before the rename is, or a power loss could keep the rename only:
+	else if (fsync(fd) != 0) failed = RG_SNAPSHOT_STEP_SYNC_;
+
+	if (close(fd) != 0 && failed == RG_SNAPSHOT_STEP_DONE_) failed = RG_SNAPSHOT_STEP_WRITE_;
+	if (failed == RG_SNAPSHOT_STEP_DONE_ && rename(paths->tempPath, paths->path) != 0) failed = RG_SNAPSHOT_STEP_RENAME_;
+
+	if (failed != RG_SNAPSHOT_STEP_DONE_) {
+		int error = errno;
+		unlink(paths->tempPath);
+		errno = error;
+		return failed;
+	}
+
+	// and the rename itself only lasts once the directory entry is flushed. some file systems
+	// can't sync directories and say so with EINVAL; there is nothing more to do on those.
+	int dirFd = open(paths->dirPath, O_RDONLY | O_DIRECTORY);
+	if (dirFd < 0) return RG_SNAPSHOT_STEP_SYNC_DIR_;
+	if (fsync(dirFd) != 0 && errno != EINVAL) failed = RG_SNAPSHOT_STEP_SYNC_DIR_;
+	int error = errno;
+	close(dirFd);
+	errno = error;
+	return failed;
+}
+
+bool RgSnapshot_Save(const RgWorld *world, const char *path) {
+	if (!RG_SNAPSHOT_NATIVE_) {
+		RgLogError("Snapshots are only supported on little-endian hosts.");
+		return false;
+	}
+
+	RgSnapshotPaths_ paths;
+	if (!RgSnapshot_MakePaths_(&paths, path)) return false;
+
+	RgSnapshotStep_ failed = RgSnapshot_Write_(world, &paths);
+	if (failed == RG_SNAPSHOT_STEP_DONE_) return true;
+
+	RgLogError("Failed to %s snapshot %s: %s", RgSnapshot_StepNames_[failed],
+		failed == RG_SNAPSHOT_STEP_RENAME_ || failed == RG_SNAPSHOT_STEP_SYNC_DIR_ ? path : paths.tempPath, strerror(errno));
+	return false;
+}
+
+int RgSnapshot_SaveForked(const RgWorld *world, const char *path) {
+	if (!RG_SNAPSHOT_NATIVE_) {
+		RgLogError("Snapshots are only supported on little-endian hosts.");
+		return -1;
+	}
+
+	RgSnapshotPaths_ paths;
+	if (!RgSnapshot_MakePaths_(&paths, path)) return -1;
+
+	pid_t pid = fork();
+	if (pid < 0) {
+		RgLogError("Failed to fork for snapshot: %s", strerror(errno));
+		return -1;
+	}
+
+	// another thread may have held the stdio or malloc locks at the fork, so the child sticks to
+	// system calls and reports through its exit status:
+	if (pid == 0) _exit(RgSnapshot_Write_(world, &paths));
+	return pid;
+}
+
+bool RgSnapshot_WaitForked(int pid) {
+	int status;
+	while (waitpid(pid, &status, 0) < 0) {
+		if (errno != EINTR) {
+			RgLogError("Failed to wait for snapshot writer: %s", strerror(errno));
+			return false;
+		}
+	}
+
+	if (!WIFEXITED(status)) {
+		RgLogError("Snapshot writer did not exit normally.");
+		return false;
+	}
+	int failed = WEXITSTATUS(status);
+	if (failed == RG_SNAPSHOT_STEP_DONE_) return true;
+
+	if (failed < RG_SNAPSHOT_STEP_COUNT_) RgLogError("Snapshot writer failed to %s the snapshot.", RgSnapshot_StepNames_[failed]);
+	else RgLogError("Snapshot writer failed with status %d.", failed);
+	return false;
+}
+
+static bool RgSnapshot_CheckSection_(const RgSnapshot *self, const RgSnapshotSection *section, uint64_t recordSize, const char *name) {
+	if (section->offset % RG_SNAPSHOT_ALIGN != 0
+		|| section->offset > self->size
+		|| section->size > self->size - section->offset
+		|| section->count > section->size / recordSize
+		|| section->size != section->count * recordSize
+	) {
+		RgLogError("Snapshot %s section is out of bounds.", name);
+		return false;
+	}
+	return true;
+}
+
+static bool RgSnapshot_Validate_(const RgSnapshot *self, bool verify) {
+	const RgSnapshotHeader *header = self->header;
+
+	if (self->size < sizeof(*header) || header->magic != RG_SNAPSHOT_MAGIC) {
+		RgLogError("Not a snapshot file.");
+		return false;
+	}
+
+	if (header->version != RG_SNAPSHOT_VERSION || header->headerSize != sizeof(*header)) {
+		RgLogError("Unsupported snapshot version %u.", (unsigned)header->version);
+		return false;
+	}
+
+	if (header->headerChecksum != RgSnapshot_HeaderChecksum_(header)) {
+		RgLogError("Snapshot header checksum mismatch.");
+		return false;
+	}
+
+	if (header->fileSize != self->size) {
+		RgLogError("Snapshot is truncated (%zu of %llu bytes).", self->size, (unsigned long long)header->fileSize);
+		return false;
+	}
+
+	if (header->chunkSize != RG_CHUNK_SIZE
+		|| header->chunkRecordSize != sizeof(RgChunk)
+		|| header->entityRecordSize != sizeof(RgEntity)
+	) {
+		RgLogError("Snapshot record layout does not match this build.");
+		return false;
+	}
+
+	if (!RgSnapshot_CheckSection_(self, &header->chunks, sizeof(RgChunk), "chunk")) return false;
+	if (!RgSnapshot_CheckSection_(self, &header->entities, sizeof(RgEntity), "entity")) return false;
+
+	if (verify) {
+		const uint8_t *base = self->data;
+		if (RgHash(base + header->chunks.offset, header->chunks.size, RG_SNAPSHOT_MAGIC) != header->chunks.checksum
+			|| RgHash(base + header->entities.offset, header->entities.size, RG_SNAPSHOT_MAGIC) != header->entities.checksum
+		) {
+			RgLogError("Snapshot data checksum mismatch.");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool RgSnapshot_Open(RgSnapshot *self, const char *path, bool verify) {
+	self->data = NULL;
+	self->size = 0;
+	self->header = NULL;
+
+	if (!RG_SNAPSHOT_NATIVE_) {
+		RgLogError("Snapshots are only supported on little-endian hosts.");
+		return false;
+	}
+
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		RgLogError("Failed to open snapshot %s: %s", path, strerror(errno));
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(RgSnapshotHeader)) {
+		RgLogError("Snapshot %s is too small.", path);
+		close(fd);
+		return false;
+	}
+
+	// private mapping: pages are faulted in lazily and writes stay in memory.
+	void *data = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED) {
+		RgLogError("Failed to map snapshot %s: %s", path, strerror(errno));
+		return false;
+	}
+
+	self->data = data;
+	self->size = st.st_size;
+	self->header = data;
+
+	if (!RgSnapshot_Validate_(self, verify)) {
+		RgLogError("Rejected snapshot %s.", path);
+		RgSnapshot_Close(self);
+		return false;
+	}
+
+	return true;
+}
+
+void RgSnapshot_GetWorld(RgSnapshot *self, RgWorld *world) {
+	uint8_t *base = self->data;
+	world->chunks = (RgChunk *)(base + self->header->chunks.offset);
+	world->chunkCount = self->header->chunks.count;
+	world->chunkCapacity = 0;
+	world->entities = (RgEntity *)(base + self->header->entities.offset);
+	world->entityCount = self->header->entities.count;
+	world->entityCapacity = 0;
+	world->rng = self->header->rng;
+	world->chunkTable = NULL;
+	world->chunkTableCapacity = world->chunkTableCount = 0;
+}
+
+void RgSnapshot_Close(RgSnapshot *self) {
+	if (self->data != NULL) munmap(self->data, self->size);
+	self->data = NULL;
+	self->size = 0;
+	self->header = NULL;
+}
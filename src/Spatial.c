@@ -0,0 +1,288 @@
+#include <Rogue/Spatial.h>
+#include <Rogue/Core.h>
+
+static_assert(RG_CHUNK_SIZE == 32, "spatial blocks keep one 32-bit occupancy word per row");
+
+typedef struct RgSpatialBlock_ {
+	int32_t x, y; /* position in blocks. */
+	RgSize count; /* nodes filed in this block. */
+	uint32_t occupied[RG_CHUNK_SIZE]; /* bit x of word y is set when tile (x, y) has nodes. */
+	RgSpatialNode *heads[RG_CHUNK_AREA];
+} RgSpatialBlock_;
+
+static inline RgSize RgSpatialGrid_Slot_(int32_t x, int32_t y, RgSize capacity) {
+	uint64_t key = ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+	key *= 0x9E3779B97F4A7C15ull;
+	return (key ^ (key >> 32)) & (capacity - 1);
+}
+
+static RgSpatialBlock_ *RgSpatialGrid_Find_(RgSpatialGrid *self, int32_t x, int32_t y) {
+	RgSpatialBlock_ *last = self->lastBlock;
+	if (last != NULL && last->x == x && last->y == y) return last;
+	if (self->blockCapacity == 0) return NULL;
+
+	for (RgSize slot = RgSpatialGrid_Slot_(x, y, self->blockCapacity);; slot = (slot + 1) & (self->blockCapacity - 1)) {
+		RgSpatialBlock_ *block = self->blocks[slot];
+		if (block == NULL) return NULL;
+		if (block->x == x && block->y == y) return self->lastBlock = block;
+	}
+}
+
+static void RgSpatialGrid_File_(RgSpatialBlock_ **blocks, RgSize capacity, RgSpatialBlock_ *block) {
+	RgSize slot = RgSpatialGrid_Slot_(block->x, block->y, capacity);
+	while (blocks[slot] != NULL) slot = (slot + 1) & (capacity - 1);
+	blocks[slot] = block;
+}
+
+static RgSpatialBlock_ *RgSpatialGrid_FindOrCreate_(RgSpatialGrid *self, int32_t x, int32_t y) {
+	RgSpatialBlock_ *block = RgSpatialGrid_Find_(self, x, y);
+	if (block != NULL) return block;
+
+	// keep the table at most half full:
+	if ((self->blockCount + 1) * 2 > self->blockCapacity) {
+		RgSize capacity = Rg_Max(self->blockCapacity * 2, (RgSize)64);
+		RgSpatialBlock_ **blocks = RgAllocArray(sizeof(*blocks), capacity);
+		if (blocks == NULL) RgFail("Failed to grow spatial block table to %zu slots.", capacity);
+		RgMemFill(0, blocks, sizeof(*blocks) * capacity);
+
+		for (RgSize i = 0; i < self->blockCapacity; ++i)
+			if (self->blocks[i] != NULL) RgSpatialGrid_File_(blocks, capacity, self->blocks[i]);
+
+		RgDeAlloc(self->blocks);
+		self->blocks = blocks;
+		self->blockCapacity = capacity;
+	}
+
+	block = RgAlloc(sizeof(*block));
+	if (block == NULL) RgFail("Failed to allocate a spatial block.");
+	RgMemFill(0, block, sizeof(*block));
+	block->x = x;
+	block->y = y;
+
+	RgSpatialGrid_File_(self->blocks, self->blockCapacity, block);
+	if (self->blockCount == 0) {
+		self->blockBounds.x0 = self->blockBounds.x1 = x;
+		self->blockBounds.y0 = self->blockBounds.y1 = y;
+	} else {
+		if (x < self->blockBounds.x0) self->blockBounds.x0 = x;
+		if (x > self->blockBounds.x1) self->blockBounds.x1 = x;
+		if (y < self->blockBounds.y0) self->blockBounds.y0 = y;
+		if (y > self->blockBounds.y1) self->blockBounds.y1 = y;
+	}
+	++self->blockCount;
+	return self->lastBlock = block;
+}
+
+void RgSpatialGrid_Init(RgSpatialGrid *self) {
+	RgMemFill(0, self, sizeof(*self));
+}
+
+void RgSpatialGrid_DeInit(RgSpatialGrid *self) {
+	for (RgSize i = 0; i < self->blockCapacity; ++i)
+		RgDeAlloc(self->blocks[i]);
+	RgDeAlloc(self->blocks);
+	RgMemFill(0, self, sizeof(*self));
+}
+
+void RgSpatialGrid_Insert(RgSpatialGrid *self, RgSpatialNode *node, int32_t x, int32_t y) {
+	int32_t blockX = RgWorld_ChunkCoord(x), blockY = RgWorld_ChunkCoord(y);
+	RgSpatialBlock_ *block = RgSpatialGrid_FindOrCreate_(self, blockX, blockY);
+
+	uint32_t localX = (uint32_t)(x - blockX * RG_CHUNK_SIZE), localY = (uint32_t)(y - blockY * RG_CHUNK_SIZE);
+	RgSpatialNode **head = &block->heads[localY * RG_CHUNK_SIZE + localX];
+
+	node->x = x;
+	node->y = y;
+	node->block = block;
+	node->prev = NULL;
+	node->next = *head;
+	if (*head != NULL) (*head)->prev = node;
+	*head = node;
+
+	block->occupied[localY] |= 1u << localX;
+	++block->count;
+	++self->nodeCount;
+}
+
+void RgSpatialGrid_Remove(RgSpatialGrid *self, RgSpatialNode *node) {
+	RgSpatialBlock_ *block = node->block;
+	if (block == NULL) return;
+
+	uint32_t localX = (uint32_t)(node->x - block->x * RG_CHUNK_SIZE), localY = (uint32_t)(node->y - block->y * RG_CHUNK_SIZE);
+	RgSpatialNode **head = &block->heads[localY * RG_CHUNK_SIZE + localX];
+
+	if (node->prev != NULL) node->prev->next = node->next;
+	else *head = node->next;
+	if (node->next != NULL) node->next->prev = node->prev;
+	if (*head == NULL) block->occupied[localY] &= ~(1u << localX);
+
+	node->next = node->prev = NULL;
+	node->block = NULL;
+	--block->count;
+	--self->nodeCount;
+}
+
+void RgSpatialGrid_Move(RgSpatialGrid *self, RgSpatialNode *node, int32_t x, int32_t y) {
+	if (node->block != NULL && node->x == x && node->y == y) return;
+	RgSpatialGrid_Remove(self, node);
+	RgSpatialGrid_Insert(self, node, x, y);
+}
+
+RgSpatialNode *RgSpatialGrid_At(RgSpatialGrid *self, int32_t x, int32_t y) {
+	int32_t blockX = RgWorld_ChunkCoord(x), blockY = RgWorld_ChunkCoord(y);
+	RgSpatialBlock_ *block = RgSpatialGrid_Find_(self, blockX, blockY);
+	if (block == NULL) return NULL;
+	return block->heads[(y - blockY * RG_CHUNK_SIZE) * RG_CHUNK_SIZE + (x - blockX * RG_CHUNK_SIZE)];
+}
+
+bool RgSpatialGrid_IsOccupied(RgSpatialGrid *self, int32_t x, int32_t y) {
+	return RgSpatialGrid_At(self, x, y) != NULL;
+}
+
+/* visits the nodes of `block` in [x0, x1] x [y0, y1], skipping empty tiles through the occupancy
+   words. returns false if `func` stopped the scan. */
+static bool RgSpatialGrid_ScanBlock_(RgSpatialBlock_ *block, int32_t x0, int32_t y0, int32_t x1, int32_t y1, RgSpatialVisitFunc *func, void *data, RgSize *visited) {
+	if (block->count == 0) return true;
+
+	int64_t baseX = (int64_t)block->x * RG_CHUNK_SIZE, baseY = (int64_t)block->y * RG_CHUNK_SIZE;
+	int64_t localX0 = x0 > baseX ? x0 - baseX : 0, localX1 = x1 < baseX + RG_CHUNK_SIZE - 1 ? x1 - baseX : RG_CHUNK_SIZE - 1;
+	int64_t localY0 = y0 > baseY ? y0 - baseY : 0, localY1 = y1 < baseY + RG_CHUNK_SIZE - 1 ? y1 - baseY : RG_CHUNK_SIZE - 1;
+	uint32_t mask = (~0u >> (RG_CHUNK_SIZE - 1 - (localX1 - localX0))) << localX0;
+
+	for (int64_t localY = localY0; localY <= localY1; ++localY) {
+		for (uint32_t bits = block->occupied[localY] & mask; bits != 0; bits &= bits - 1) {
+			RgSpatialNode *node = block->heads[localY * RG_CHUNK_SIZE + __builtin_ctz(bits)];
+			for (RgSpatialNode *next; node != NULL; node = next) {
+				next = node->next;
+				++*visited;
+				if (!func(data, node)) return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/* visits the nodes in [x0, x1] x [y0, y1] block by block. returns false if `func` stopped the scan. */
+static bool RgSpatialGrid_Scan_(RgSpatialGrid *self, int32_t x0, int32_t y0, int32_t x1, int32_t y1, RgSpatialVisitFunc *func, void *data, RgSize *visited) {
+	if (x0 > x1 || y0 > y1 || self->nodeCount == 0) return true;
+
+	int32_t blockX0 = RgWorld_ChunkCoord(x0), blockX1 = RgWorld_ChunkCoord(x1);
+	int32_t blockY0 = RgWorld_ChunkCoord(y0), blockY1 = RgWorld_ChunkCoord(y1);
+
+	// a rectangle spanning more block coordinates than there are blocks is cheaper to answer by
+	// walking the table than by looking up every coordinate:
+	uint64_t area = (uint64_t)((int64_t)blockX1 - blockX0 + 1) * (uint64_t)((int64_t)blockY1 - blockY0 + 1);
+	if (area > self->blockCount) {
+		for (RgSize i = 0; i < self->blockCapacity; ++i) {
+			RgSpatialBlock_ *block = self->blocks[i];
+			if (block == NULL || block->x < blockX0 || block->x > blockX1 || block->y < blockY0 || block->y > blockY1) continue;
+			if (!RgSpatialGrid_ScanBlock_(block, x0, y0, x1, y1, func, data, visited)) return false;
+		}
+		return true;
+	}
+
+	for (int64_t blockY = blockY0; blockY <= blockY1; ++blockY)
+	for (int64_t blockX = blockX0; blockX <= blockX1; ++blockX) {
+		RgSpatialBlock_ *block = RgSpatialGrid_Find_(self, (int32_t)blockX, (int32_t)blockY);
+		if (block != NULL && !RgSpatialGrid_ScanBlock_(block, x0, y0, x1, y1, func, data, visited)) return false;
+	}
+
+	return true;
+}
+
+static inline int32_t RgSpatialGrid_Clamp_(int64_t value) {
+	return value < INT32_MIN ? INT32_MIN : value > INT32_MAX ? INT32_MAX : (int32_t)value;
+}
+
+RgSize RgSpatialGrid_QueryRect(RgSpatialGrid *self, int32_t x0, int32_t y0, int32_t x1, int32_t y1, RgSpatialVisitFunc *func, void *data) {
+	RgSize visited = 0;
+	RgSpatialGrid_Scan_(self, x0, y0, x1, y1, func, data, &visited);
+	return visited;
+}
+
+typedef struct {
+	int64_t x, y, radiusSquared;
+	RgSpatialVisitFunc *func;
+	void *data;
+	RgSize visited;
+} RgSpatialRadiusQuery_;
+
+static bool RgSpatialGrid_VisitInRadius_(void *data, RgSpatialNode *node) {
+	RgSpatialRadiusQuery_ *query = data;
+	int64_t dx = node->x - query->x, dy = node->y - query->y;
+	if (dx * dx + dy * dy > query->radiusSquared) return true;
+	++query->visited;
+	return query->func(query->data, node);
+}
+
+RgSize RgSpatialGrid_QueryRadius(RgSpatialGrid *self, int32_t x, int32_t y, int32_t radius, RgSpatialVisitFunc *func, void *data) {
+	if (radius < 0) return 0;
+
+	RgSpatialRadiusQuery_ query = {
+		.x = x, .y = y, .radiusSquared = (int64_t)radius * radius,
+		.func = func, .data = data,
+	};
+	RgSize scanned = 0;
+	RgSpatialGrid_Scan_(self,
+		RgSpatialGrid_Clamp_((int64_t)x - radius), RgSpatialGrid_Clamp_((int64_t)y - radius),
+		RgSpatialGrid_Clamp_((int64_t)x + radius), RgSpatialGrid_Clamp_((int64_t)y + radius),
+		&RgSpatialGrid_VisitInRadius_, &query, &scanned);
+	return query.visited;
+}
+
+typedef struct {
+	int64_t x, y;
+	RgSpatialFilterFunc *filter;
+	void *data;
+	RgSpatialNode *best;
+	int64_t bestDistance;
+} RgSpatialNearestQuery_;
+
+static bool RgSpatialGrid_VisitNearest_(void *data, RgSpatialNode *node) {
+	RgSpatialNearestQuery_ *query = data;
+	int64_t dx = node->x - query->x, dy = node->y - query->y;
+	int64_t distance = dx * dx + dy * dy;
+	if (distance >= query->bestDistance) return true;
+	if (query->filter != NULL && !query->filter(query->data, node)) return true;
+
+	query->best = node;
+	query->bestDistance = distance;
+	return true;
+}
+
+RgSpatialNode *RgSpatialGrid_Nearest(RgSpatialGrid *self, int32_t x, int32_t y, int32_t maxRadius, RgSpatialFilterFunc *filter, void *data) {
+	if (maxRadius < 0 || self->nodeCount == 0) return NULL;
+
+	// a square this large around (x, y) covers every block, so growing it further finds nothing new:
+	int64_t tileX0 = (int64_t)self->blockBounds.x0 * RG_CHUNK_SIZE, tileX1 = ((int64_t)self->blockBounds.x1 + 1) * RG_CHUNK_SIZE - 1;
+	int64_t tileY0 = (int64_t)self->blockBounds.y0 * RG_CHUNK_SIZE, tileY1 = ((int64_t)self->blockBounds.y1 + 1) * RG_CHUNK_SIZE - 1;
+	int64_t coverRadius = 0;
+	if (x - tileX0 > coverRadius) coverRadius = x - tileX0;
+	if (tileX1 - x > coverRadius) coverRadius = tileX1 - x;
+	if (y - tileY0 > coverRadius) coverRadius = y - tileY0;
+	if (tileY1 - y > coverRadius) coverRadius = tileY1 - y;
+	int64_t lastRadius = coverRadius < maxRadius ? coverRadius : maxRadius;
+
+	RgSpatialNearestQuery_ query = {
+		.x = x, .y = y, .filter = filter, .data = data,
+		.best = NULL, .bestDistance = (int64_t)maxRadius * maxRadius + 1,
+	};
+
+	// scan squares of doubling size. anything outside a square of half-size r is further than r
+	// away, so once the best match is within r the search is over.
+	for (int64_t radius = 1;; radius *= 2) {
+		if (radius > lastRadius) radius = lastRadius;
+
+		RgSize scanned = 0;
+		query.best = NULL;
+		query.bestDistance = (int64_t)maxRadius * maxRadius + 1;
+		RgSpatialGrid_Scan_(self,
+			RgSpatialGrid_Clamp_(x - radius), RgSpatialGrid_Clamp_(y - radius),
+			RgSpatialGrid_Clamp_(x + radius), RgSpatialGrid_Clamp_(y + radius),
+			&RgSpatialGrid_VisitNearest_, &query, &scanned);
+
+		if (query.best != NULL && query.bestDistance <= radius * radius) return query.best;
+		if (radius == lastRadius) return query.best;
+	}
+}
@@ -0,0 +1,199 @@
+#include <Rogue/Turn.h>
+#include <Rogue/Core.h>
+
+#define RG_TURN_WHEEL_MASK_ (RG_TURN_WHEEL_SLOTS - 1)
+
+void RgTurnScheduler_Init(RgTurnScheduler *self) {
+	RgMemFill(0, self, sizeof(*self));
+}
+
+void RgTurnScheduler_DeInit(RgTurnScheduler *self) {
+	RgDeAlloc(self->batch);
+	RgMemFill(0, self, sizeof(*self));
+}
+
+static inline RgTurnActor **RgTurnScheduler_Head_(RgTurnScheduler *self, const RgTurnActor *actor) {
+	if (actor->level == RG_TURN_WHEEL_LEVELS) return &self->overflow;
+	return &self->slots[actor->level][actor->slot];
+}
+
+/* files a waiting actor under its due tick, relative to the current tick. */
+static void RgTurnScheduler_File_(RgTurnScheduler *self, RgTurnActor *actor) {
+	// the level is the highest 6-bit group in which the due tick differs from now:
+	uint64_t diff = actor->due ^ self->now;
+	if (diff >> (RG_TURN_WHEEL_BITS * RG_TURN_WHEEL_LEVELS) != 0) {
+		actor->level = RG_TURN_WHEEL_LEVELS;
+		actor->slot = 0;
+	} else {
+		actor->level = diff == 0 ? 0 : (63 - __builtin_clzll(diff)) / RG_TURN_WHEEL_BITS;
+		actor->slot = (actor->due >> (RG_TURN_WHEEL_BITS * actor->level)) & RG_TURN_WHEEL_MASK_;
+		self->occupied[actor->level] |= 1ull << actor->slot;
+	}
+
+	RgTurnActor **head = RgTurnScheduler_Head_(self, actor);
+	actor->prev = NULL;
+	actor->next = *head;
+	if (*head != NULL) (*head)->prev = actor;
+	*head = actor;
+	actor->state = RG_TURN_ACTOR_WAITING;
+}
+
+static void RgTurnScheduler_Unlink_(RgTurnScheduler *self, RgTurnActor *actor) {
+	RgTurnActor **head = RgTurnScheduler_Head_(self, actor);
+	if (actor->prev != NULL) actor->prev->next = actor->next;
+	else *head = actor->next;
+	if (actor->next != NULL) actor->next->prev = actor->prev;
+
+	if (*head == NULL && actor->level != RG_TURN_WHEEL_LEVELS)
+		self->occupied[actor->level] &= ~(1ull << actor->slot);
+
+	actor->next = actor->prev = NULL;
+}
+
+/* files an actor whose energy is up to date as of now under the tick it reaches the action cost. */
+static void RgTurnScheduler_Schedule_(RgTurnScheduler *self, RgTurnActor *actor) {
+	int64_t needed = (int64_t)RG_TURN_ACTION_COST - actor->energy;
+	actor->due = self->now + (needed <= 0 ? 0 : (uint64_t)((needed + actor->speed - 1) / actor->speed));
+	RgTurnScheduler_File_(self, actor);
+}
+
+static inline void RgTurnActor_UpdateEnergy_(RgTurnActor *actor, uint64_t now) {
+	actor->energy += (int32_t)((now - actor->energyTick) * actor->speed);
+	actor->energyTick = now;
+}
+
+void RgTurnScheduler_Add(RgTurnScheduler *self, RgTurnActor *actor, uint32_t speed, int32_t energy) {
+	if (speed == 0) RgFail("Turn actors need a non-zero speed.");
+	// a second add would link the actor into two lists at once:
+	if (actor->state != RG_TURN_ACTOR_IDLE) RgFail("Turn actor is already scheduled.");
+
+	actor->speed = speed;
+	actor->energy = energy;
+	actor->energyTick = self->now;
+	actor->cost = RG_TURN_ACTION_COST;
+	RgTurnScheduler_Schedule_(self, actor);
+	++self->actorCount;
+}
+
+void RgTurnScheduler_Remove(RgTurnScheduler *self, RgTurnActor *actor) {
+	if (actor->state == RG_TURN_ACTOR_IDLE) return;
+
+	// ready actors leave a hole in the batch, so neither the caller nor NextBatch reaches them again:
+	if (actor->state == RG_TURN_ACTOR_WAITING) RgTurnScheduler_Unlink_(self, actor);
+	else self->batch[actor->batchIndex] = NULL;
+	actor->state = RG_TURN_ACTOR_IDLE;
+	--self->actorCount;
+}
+
+void RgTurnScheduler_SetSpeed(RgTurnScheduler *self, RgTurnActor *actor, uint32_t speed) {
+	if (speed == 0) RgFail("Turn actors need a non-zero speed.");
+
+	if (actor->state != RG_TURN_ACTOR_WAITING) {
+		actor->speed = speed;
+		return;
+	}
+
+	RgTurnActor_UpdateEnergy_(actor, self->now);
+	actor->speed = speed;
+	RgTurnScheduler_Unlink_(self, actor);
+	RgTurnScheduler_Schedule_(self, actor);
+}
+
+/* moves the actors of the next non-empty slot above level 0 down the wheel, advancing now to
+   the start of that slot. returns false when nothing is scheduled at all. */
+static bool RgTurnScheduler_Cascade_(RgTurnScheduler *self) {
+	RgTurnActor *list = NULL;
+
+	for (int level = 1; level < RG_TURN_WHEEL_LEVELS && list == NULL; ++level) {
+		uint64_t index = (self->now >> (RG_TURN_WHEEL_BITS * level)) & RG_TURN_WHEEL_MASK_;
+		if (index == RG_TURN_WHEEL_MASK_) continue;
+
+		// slots at or before the current index are always empty, so the next one is the lowest set bit:
+		uint64_t pending = self->occupied[level] & (~0ull << (index + 1));
+		if (pending == 0) continue;
+
+		uint64_t slot = __builtin_ctzll(pending);
+		int shift = RG_TURN_WHEEL_BITS * (level + 1);
+		self->now = (self->now >> shift << shift) | (slot << (RG_TURN_WHEEL_BITS * level));
+
+		list = self->slots[level][slot];
+		self->slots[level][slot] = NULL;
+		self->occupied[level] &= ~(1ull << slot);
+	}
+
+	if (list == NULL) {
+		if (self->overflow == NULL) return false;
+
+		uint64_t earliest = UINT64_MAX;
+		for (RgTurnActor *actor = self->overflow; actor != NULL; actor = actor->next)
+			earliest = actor->due < earliest ? actor->due : earliest;
+
+		int shift = RG_TURN_WHEEL_BITS * RG_TURN_WHEEL_LEVELS;
+		self->now = earliest >> shift << shift;
+		list = self->overflow;
+		self->overflow = NULL;
+	}
+
+	while (list != NULL) {
+		RgTurnActor *next = list->next;
+		RgTurnScheduler_File_(self, list);
+		list = next;
+	}
+	return true;
+}
+
+static void RgTurnScheduler_PushBatch_(RgTurnScheduler *self, RgTurnActor *actor) {
+	if (self->batchCount == self->batchCapacity) {
+		RgSize newCapacity = Rg_Max(self->batchCapacity * 2, (RgSize)64);
+		RgTurnActor **batch = RgAllocArray(sizeof(*batch), newCapacity);
+		if (batch == NULL) RgFail("Failed to grow turn batch to %zu actors.", newCapacity);
+		if (self->batchCount != 0) __builtin_memcpy(batch, self->batch, sizeof(*batch) * self->batchCount);
+		RgDeAlloc(self->batch);
+		self->batch = batch;
+		self->batchCapacity = newCapacity;
+	}
+	actor->batchIndex = self->batchCount;
+	self->batch[self->batchCount++] = actor;
+}
+
+RgSize RgTurnScheduler_NextBatch(RgTurnScheduler *self, RgTurnActor ***batch) {
+	for (RgSize i = 0; i < self->batchCount; ++i) {
+		RgTurnActor *actor = self->batch[i];
+		if (actor == NULL) continue;
+		actor->energy -= (int32_t)actor->cost;
+		RgTurnScheduler_Schedule_(self, actor);
+	}
+
+	self->batchCount = 0;
+	*batch = self->batch;
+	if (self->actorCount == 0) return 0;
+
+	for (;;) {
+		// level 0 holds one tick per slot, for the 64-tick block containing now:
+		uint64_t index = self->now & RG_TURN_WHEEL_MASK_;
+		uint64_t pending = self->occupied[0] & (~0ull << index);
+
+		if (pending != 0) {
+			uint64_t slot = __builtin_ctzll(pending);
+			self->now = (self->now & ~(uint64_t)RG_TURN_WHEEL_MASK_) | slot;
+
+			RgTurnActor *list = self->slots[0][slot];
+			self->slots[0][slot] = NULL;
+			self->occupied[0] &= ~(1ull << slot);
+
+			for (RgTurnActor *actor = list, *next; actor != NULL; actor = next) {
+				next = actor->next;
+				actor->next = actor->prev = NULL;
+				actor->state = RG_TURN_ACTOR_READY;
+				actor->cost = RG_TURN_ACTION_COST;
+				RgTurnActor_UpdateEnergy_(actor, self->now);
+				RgTurnScheduler_PushBatch_(self, actor);
+			}
+
+			*batch = self->batch;
+			return self->batchCount;
+		}
+
+		if (!RgTurnScheduler_Cascade_(self)) return 0;
+	}
+}
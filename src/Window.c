@@ -1,7 +1,15 @@
+#define _POSIX_C_SOURCE 200809L
 #include <Rogue/Window.h>
 #include <Rogue/Core.h>
 #include <GL/gl3w.h>
 #include <GLFW/glfw3.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <stdatomic.h>
+#include <threads.h>
+#include <time.h>
 
 const char *RgGlDebugSourceToString(GLenum source) {
 	switch (source) {
@@ -65,8 +73,30 @@ struct RgWindowImpl {
 	GLuint vao;
 	GLint scaleUniform, textureUniform;
 	RgKeyState *keyStates;
+	RgPixel *presentedBuffer; /* headless stand-in for the texture, NULL otherwise. */
+	bool printStartupTimes;
+	uint64_t startTime, lastStepTime; /* RgTimeNs at init and at the last logged step. */
+	bool presentedFirstFrame;
+	bool redraw; /* the buffer is new and has to be drawn: first frame or resize. */
+	bool exposed; /* the window has to be presented again, but the frame is still valid. */
+	bool inputArrived; /* input since the last refresh. */
+	atomic_bool woken; /* RgWindow_Wake was called since the last RgWindow_BeginFrame. */
+	mtx_t wakeLock; /* headless waiting on wakeCond. */
+	cnd_t wakeCond;
 };
 
+static void RgWindow_LogStartupStep_(RgWindow *self, const char *step) {
+	if (!self->impl_->printStartupTimes) return;
+	uint64_t now = RgTimeNs();
+	RgLogInfo(
+		"startup: %-24s %8.2f ms (total %8.2f ms)",
+		step,
+		(now - self->impl_->lastStepTime) / 1e6,
+		(now - self->impl_->startTime) / 1e6
+	);
+	self->impl_->lastStepTime = now;
+}
+
 void RgGlfwErrorCallback(int error, const char *message) {
 	RgLogError("GLFW Error (%d): %s", error, message);
 }
@@ -81,15 +111,22 @@ void RgGlfwKeyCallback(GLFWwindow *window, int key, int scancode, int action, in
 	};
 
 	self->impl_->keyStates[key] = map[action];
+	self->impl_->inputArrived = true;
+}
+
+void RgGlfwWindowRefreshCallback(GLFWwindow *window) {
+	RgWindow *self = glfwGetWindowUserPointer(window);
+	self->impl_->exposed = true;
 }
 
 void RgGlfwWindowSizeCallback(GLFWwindow *window, int newWidth, int newHeight);
 
-static void RgWindow_CreateWindow_(RgWindow *self) {
+static void RgWindow_CreateWindow_(RgWindow *self, bool debugContext) {
 	glfwSetErrorCallback(&RgGlfwErrorCallback);
 	if (!glfwInit()) RgFail("Failed to initialize GLFW.");
+	RgWindow_LogStartupStep_(self, "glfwInit");
 	
-	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
+	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, debugContext ? GL_TRUE : GL_FALSE);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
@@ -101,13 +138,19 @@ static void RgWindow_CreateWindow_(RgWindow *self) {
 
 	glfwSetKeyCallback(self->impl_->window, &RgGlfwKeyCallback);
 	glfwSetWindowSizeCallback(self->impl_->window, &RgGlfwWindowSizeCallback);
+	glfwSetWindowRefreshCallback(self->impl_->window, &RgGlfwWindowRefreshCallback);
 
 	glfwMakeContextCurrent(self->impl_->window);
+	RgWindow_LogStartupStep_(self, "window and context");
+
 	if (gl3wInit() < 0) RgFail("Failed to initialize GL3W.");
+	RgWindow_LogStartupStep_(self, "gl3wInit");
 
-	glEnable(GL_DEBUG_OUTPUT);
-	glDebugMessageCallback(&RgGlMessageCallback, NULL);
-	glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, NULL, GL_TRUE);
+	if (debugContext) {
+		glEnable(GL_DEBUG_OUTPUT);
+		glDebugMessageCallback(&RgGlMessageCallback, NULL);
+		glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, NULL, GL_TRUE);
+	}
 }
 
 static void RgWindow_CreateTexture_(RgWindow *self) {
@@ -119,75 +162,205 @@ static void RgWindow_CreateTexture_(RgWindow *self) {
 	glTextureStorage2D(self->impl_->texture, 1, GL_RGBA8, self->bufferWidth, self->bufferHeight);
 }
 
-static void RgWindow_CreateShaderProgram_(RgWindow *self) {
-	self->impl_->shader = glCreateProgram();
-	GLuint vShader = glCreateShader(GL_VERTEX_SHADER);
-	GLuint fShader = glCreateShader(GL_FRAGMENT_SHADER);
-
-	{
-		static const char *source =
-			"#version 460 core\n"
-			"out vec2 sUV;\n"
-			"void main() {\n"
-			"  const vec2 vertices[3] = vec2[3](vec2(-1,-1), vec2(3,-1), vec2(-1, 3));\n"
-			"  gl_Position = vec4(vertices[gl_VertexID], 0, 1);\n"
-			"  sUV = 0.5 * gl_Position.xy + vec2(0.5); sUV.y = 1.0 - sUV.y;\n"
-			"}\n";
-
-		glShaderSource(vShader, 1, &source, NULL);
-		glCompileShader(vShader);
-
-		GLint success = GL_FALSE;
-		glGetShaderiv(vShader, GL_COMPILE_STATUS, &success);
-
-		if(!success) {
-			GLchar message[1024];
-			glGetShaderInfoLog(vShader, 1024, NULL, message);
-			RgFail("Failed to compile vertex shader:\n%s", message);
-		}
+static const char *RgWindow_VertexShaderSource_ =
+	"#version 460 core\n"
+	"out vec2 sUV;\n"
+	"void main() {\n"
+	"  const vec2 vertices[3] = vec2[3](vec2(-1,-1), vec2(3,-1), vec2(-1, 3));\n"
+	"  gl_Position = vec4(vertices[gl_VertexID], 0, 1);\n"
+	"  sUV = 0.5 * gl_Position.xy + vec2(0.5); sUV.y = 1.0 - sUV.y;\n"
+	"}\n";
+
+static const char *RgWindow_FragmentShaderSource_ =
+	"#version 460 core\n"
+	"uniform sampler2D uTex;\n"
+	"uniform vec2 uScale;\n"
+	"in vec2 sUV;\n"
+	"out vec4 oColor;\n"
+	"void main() {\n"
+	"  vec2 uv = vec2(sUV.x / uScale.x, sUV.y / uScale.y);\n"
+	"  oColor = texture(uTex, uv);\n"
+	"}\n";
+
+#define RG_PROGRAM_CACHE_MAGIC 0x50475252u /* "RRGP" */
+#define RG_PROGRAM_CACHE_VERSION 1
+
+/* header of a cached program binary file. the binary itself follows. */
+typedef struct {
+	uint32_t magic, version;
+	uint64_t key; /* RgWindow_ProgramCacheKey_ of the context that produced the binary. */
+	uint64_t checksum; /* RgHash of the binary. */
+	uint32_t format; /* binary format reported by glGetProgramBinary. */
+	uint32_t length; /* binary length in bytes. */
+} RgProgramCacheHeader;
+
+/* binaries are only valid for the same sources on the same driver, so all of it goes in the key. */
+static uint64_t RgWindow_ProgramCacheKey_(void) {
+	const char *parts[] = {
+		RgWindow_VertexShaderSource_,
+		RgWindow_FragmentShaderSource_,
+		(const char *)glGetString(GL_VENDOR),
+		(const char *)glGetString(GL_RENDERER),
+		(const char *)glGetString(GL_VERSION),
+	};
+
+	uint64_t key = RG_PROGRAM_CACHE_VERSION;
+	for (RgSize i = 0; i < sizeof(parts) / sizeof(*parts); ++i) {
+		const char *part = parts[i] != NULL ? parts[i] : "";
+		key = RgHash(part, strlen(part) + 1, key);
 	}
-	
-	{
-		static const char *source =
-			"#version 460 core\n"
-			"uniform sampler2D uTex;\n"
-			"uniform vec2 uScale;\n"
-			"in vec2 sUV;\n"
-			"out vec4 oColor;\n"
-			"void main() {\n"
-			"  vec2 uv = vec2(sUV.x / uScale.x, sUV.y / uScale.y);\n"
-			"  oColor = texture(uTex, uv);\n"
-			"}\n";
-
-		glShaderSource(fShader, 1, &source, NULL);
-		glCompileShader(fShader);
-
-		GLint success = GL_FALSE;
-		glGetShaderiv(fShader, GL_COMPILE_STATUS, &success);
-
-		if(!success) {
-			GLchar message[1024];
-			glGetShaderInfoLog(fShader, 1024, NULL, message);
-			RgFail("Failed to compile fragment shader:\n%s", message);
-		}
+	return key;
+}
+
+static bool RgWindow_LoadProgramBinary_(GLuint program, const char *path, uint64_t key) {
+	FILE *file = fopen(path, "rb");
+	if (file == NULL) return false;
+
+	bool ok = false;
+	void *binary = NULL;
+	RgProgramCacheHeader header;
+
+	if (fread(&header, sizeof(header), 1, file) != 1) goto done;
+	if (header.magic != RG_PROGRAM_CACHE_MAGIC || header.version != RG_PROGRAM_CACHE_VERSION || header.key != key)
+		goto done;
+
+	// a corrupt or truncated file must not decide how much to allocate:
+	struct stat info;
+	if (fstat(fileno(file), &info) != 0 || info.st_size < 0
+		|| (uint64_t)info.st_size != sizeof(header) + (uint64_t)header.length)
+		goto done;
+
+	binary = RgAlloc(header.length);
+	if (binary == NULL || fread(binary, 1, header.length, file) != header.length) goto done;
+	if (RgHash(binary, header.length, key) != header.checksum) goto done;
+
+	// the driver may still reject the binary (e.g. after an update it doesn't report in GL_VERSION):
+	glProgramBinary(program, header.format, binary, header.length);
+	GLint success = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	ok = success == GL_TRUE;
+
+done:
+	RgDeAlloc(binary);
+	fclose(file);
+	return ok;
+}
+
+static void RgWindow_SaveProgramBinary_(GLuint program, const char *dir, const char *path, uint64_t key) {
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) return;
+
+	void *binary = RgAlloc(length);
+	if (binary == NULL) return;
+
+	RgProgramCacheHeader header = {
+		.magic = RG_PROGRAM_CACHE_MAGIC,
+		.version = RG_PROGRAM_CACHE_VERSION,
+		.key = key,
+	};
+
+	GLenum format = 0;
+	glGetProgramBinary(program, length, &length, &format, binary);
+	header.format = format;
+	header.length = length;
+	header.checksum = RgHash(binary, header.length, key);
+
+	if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+		RgLogError("Failed to create shader cache directory %s: %s", dir, strerror(errno));
+		RgDeAlloc(binary);
+		return;
 	}
 
-	{
-		glAttachShader(self->impl_->shader, vShader);
-		glAttachShader(self->impl_->shader, fShader);
-		glLinkProgram(self->impl_->shader);
-		GLint success = GL_FALSE;
-		glGetProgramiv(self->impl_->shader, GL_LINK_STATUS, &success);
-		if(success != GL_TRUE) {
-			GLsizei log_length = 0;
-			GLchar message[1024];
-			glGetProgramInfoLog(self->impl_->shader, 1024, &log_length, message);
-			RgFail("Failed to link shader program:\n%s", message);
-		}
+	// write to a temporary file first so a concurrent launch never reads a partial binary:
+	char tempPath[4096];
+	if (snprintf(tempPath, sizeof(tempPath), "%s.tmp", path) >= (int)sizeof(tempPath)) {
+		RgDeAlloc(binary);
+		return;
 	}
 
+	FILE *file = fopen(tempPath, "wb");
+	bool ok = file != NULL
+		&& fwrite(&header, sizeof(header), 1, file) == 1
+		&& fwrite(binary, 1, header.length, file) == header.length;
+	if (file != NULL && fclose(file) != 0) ok = false;
+
+	if (!ok || rename(tempPath, path) != 0) {
+		RgLogError("Failed to write shader cache %s.", path);
+		remove(tempPath);
+	}
+
+	RgDeAlloc(binary);
+}
+
+static GLuint RgWindow_CompileShader_(GLenum type, const char *source, const char *name) {
+	GLuint shader = glCreateShader(type);
+	glShaderSource(shader, 1, &source, NULL);
+	glCompileShader(shader);
+
+	GLint success = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+
+	if(!success) {
+		GLchar message[1024];
+		glGetShaderInfoLog(shader, 1024, NULL, message);
+		RgFail("Failed to compile %s shader:\n%s", name, message);
+	}
+
+	return shader;
+}
+
+static void RgWindow_LinkShaderProgram_(RgWindow *self) {
+	GLuint vShader = RgWindow_CompileShader_(GL_VERTEX_SHADER, RgWindow_VertexShaderSource_, "vertex");
+	GLuint fShader = RgWindow_CompileShader_(GL_FRAGMENT_SHADER, RgWindow_FragmentShaderSource_, "fragment");
+
+	glAttachShader(self->impl_->shader, vShader);
+	glAttachShader(self->impl_->shader, fShader);
+	glLinkProgram(self->impl_->shader);
+	GLint success = GL_FALSE;
+	glGetProgramiv(self->impl_->shader, GL_LINK_STATUS, &success);
+	if(success != GL_TRUE) {
+		GLsizei log_length = 0;
+		GLchar message[1024];
+		glGetProgramInfoLog(self->impl_->shader, 1024, &log_length, message);
+		RgFail("Failed to link shader program:\n%s", message);
+	}
+
+	glDetachShader(self->impl_->shader, vShader);
+	glDetachShader(self->impl_->shader, fShader);
 	glDeleteShader(vShader);
 	glDeleteShader(fShader);
+}
+
+static void RgWindow_CreateShaderProgram_(RgWindow *self, const char *cacheDir) {
+	self->impl_->shader = glCreateProgram();
+
+	GLint binaryFormatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+
+	if (cacheDir != NULL && binaryFormatCount > 0) {
+		uint64_t key = RgWindow_ProgramCacheKey_();
+		char path[4096];
+		if (snprintf(path, sizeof(path), "%s/program-%016llx.bin", cacheDir, (unsigned long long)key) >= (int)sizeof(path)) {
+			// a truncated path could name some other file, so go without the cache:
+			RgLogError("Shader cache directory %s is too long, not caching.", cacheDir);
+			RgWindow_LinkShaderProgram_(self);
+			RgWindow_LogStartupStep_(self, "shaders (compiled)");
+		} else if (RgWindow_LoadProgramBinary_(self->impl_->shader, path, key)) {
+			RgWindow_LogStartupStep_(self, "shaders (cached)");
+		} else {
+			// a rejected binary leaves the program unlinked, so start from a fresh one:
+			glDeleteProgram(self->impl_->shader);
+			self->impl_->shader = glCreateProgram();
+			glProgramParameteri(self->impl_->shader, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+			RgWindow_LinkShaderProgram_(self);
+			RgWindow_SaveProgramBinary_(self->impl_->shader, cacheDir, path, key);
+			RgWindow_LogStartupStep_(self, "shaders (compiled)");
+		}
+	} else {
+		RgWindow_LinkShaderProgram_(self);
+		RgWindow_LogStartupStep_(self, "shaders (compiled)");
+	}
 
 	self->impl_->scaleUniform = glGetUniformLocation(self->impl_->shader, "uScale");
 	self->impl_->textureUniform = glGetUniformLocation(self->impl_->shader, "uTex");
@@ -219,6 +392,7 @@ void RgGlfwWindowSizeCallback(GLFWwindow *window, int newWidth, int newHeight) {
 
 	glDeleteTextures(1, &self->impl_->texture);
 	RgWindow_CreateTexture_(self);
+	self->impl_->redraw = true;
 }
 
 void RgWindow_Init(RgWindow *self, const RgWindowInitInfo *info) {
@@ -229,43 +403,101 @@ void RgWindow_Init(RgWindow *self, const RgWindowInitInfo *info) {
 	self->buffer = NULL;
 	self->impl_ = RgAlloc(sizeof(*self->impl_));
 	self->impl_->keyStates = RgAllocArray(sizeof(*self->impl_->keyStates), RG_KEY_MAX_ + 1);
+	self->impl_->printStartupTimes = info->printStartupTimes;
+	self->impl_->startTime = self->impl_->lastStepTime = RgTimeNs();
+	self->impl_->presentedFirstFrame = false;
+	self->impl_->window = NULL;
+	self->impl_->presentedBuffer = NULL;
+	self->impl_->redraw = true;
+	self->impl_->exposed = self->impl_->inputArrived = false;
+	atomic_init(&self->impl_->woken, false);
+	if (mtx_init(&self->impl_->wakeLock, mtx_plain) != thrd_success || cnd_init(&self->impl_->wakeCond) != thrd_success)
+		RgFail("Failed to create window wake-up primitives.");
+	self->presentedFrames = self->skippedFrames = 0;
 
 	RgWindow_CreateBuffer_(self);
-	RgWindow_CreateWindow_(self);
-	RgWindow_CreateShaderProgram_(self);
+
+	if (info->headless) {
+		self->impl_->presentedBuffer = RgAllocArray(sizeof(*self->buffer), self->bufferWidth * self->bufferHeight);
+		return;
+	}
+
+	RgWindow_CreateWindow_(self, info->debugContext);
+	RgWindow_CreateShaderProgram_(self, info->shaderCacheDir);
 	RgWindow_CreateTexture_(self);
 	RgWindow_CreateVAO_(self);
+	RgWindow_LogStartupStep_(self, "texture and vao");
 }
 
 void RgWindow_DeInit(RgWindow *self) {
-	glDeleteVertexArrays(1, &self->impl_->vao);
-	glDeleteTextures(1, &self->impl_->texture);
-	glDeleteProgram(self->impl_->shader);
+	bool headless = self->impl_->window == NULL;
 
-	glfwDestroyWindow(self->impl_->window);
+	if (!headless) {
+		glDeleteVertexArrays(1, &self->impl_->vao);
+		glDeleteTextures(1, &self->impl_->texture);
+		glDeleteProgram(self->impl_->shader);
+
+		glfwDestroyWindow(self->impl_->window);
+	}
 
 	RgDeAlloc(self->impl_->keyStates);
 	self->impl_->keyStates = NULL;
 
+	RgDeAlloc(self->impl_->presentedBuffer);
+	self->impl_->presentedBuffer = NULL;
+
+	cnd_destroy(&self->impl_->wakeCond);
+	mtx_destroy(&self->impl_->wakeLock);
+
 	RgDeAlloc(self->impl_);
 	self->impl_ = NULL;
 
-	glfwTerminate();
+	if (!headless) glfwTerminate();
 	
 	RgDeAlloc(self->buffer);
 	self->buffer = NULL;
 }
 
 bool RgWindow_ShouldStop(RgWindow *self) {
+	if (self->impl_->window == NULL) return false;
 	return glfwWindowShouldClose(self->impl_->window);
 }
 
 void RgWindow_Clear(RgWindow *self, float r, float g, float b, float a) {
+	if (self->impl_->window == NULL) return;
 	glClearColor(r, g, b, a);
 	glClear(GL_COLOR_BUFFER_BIT);
 }
 
+/* forgets the input and damage of the frame that is about to be presented. */
+static void RgWindow_EndFrame_(RgWindow *self) {
+	for (size_t i = 0; i < RG_KEY_MAX_; ++i)
+		self->impl_->keyStates[i] = RG_KEY_STATE_NONE;
+
+	self->impl_->redraw = self->impl_->exposed = self->impl_->inputArrived = false;
+	++self->presentedFrames;
+}
+
+static void RgWindow_RefreshHeadless_(RgWindow *self) {
+	// copying the frame out stands in for the texture upload, so benchmarks see its cost:
+	__builtin_memcpy(self->impl_->presentedBuffer, self->buffer, sizeof(*self->buffer) * self->bufferWidth * self->bufferHeight);
+	RgWindow_EndFrame_(self);
+}
+
+/* draws the texture to the window and swaps. */
+static void RgWindow_Present_(RgWindow *self) {
+	glUniform2f(self->impl_->scaleUniform, 1.0f, 1.0f); // don't scale twice!
+	glBindTextureUnit(0, self->impl_->texture);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glfwSwapBuffers(self->impl_->window);
+}
+
 void RgWindow_Refresh(RgWindow *self) {
+	if (self->impl_->window == NULL) {
+		RgWindow_RefreshHeadless_(self);
+		return;
+	}
+
 	glTextureSubImage2D(
 		self->impl_->texture, 0,
 		0, 0, self->bufferWidth, self->bufferHeight,
@@ -273,22 +505,77 @@ void RgWindow_Refresh(RgWindow *self) {
 		self->buffer
 	);
 
-	glUniform2f(self->impl_->scaleUniform, 1.0f, 1.0f); // don't scale twice!
-	glBindTextureUnit(0, self->impl_->texture);
-	glDrawArrays(GL_TRIANGLES, 0, 3);
-	
-	for (size_t i = 0; i < RG_KEY_MAX_; ++i)
-		self->impl_->keyStates[i] = RG_KEY_STATE_NONE;
-
-	glfwSwapBuffers(self->impl_->window);
+	RgWindow_EndFrame_(self);
+	RgWindow_Present_(self);
 	glfwPollEvents();
 
+	if (!self->impl_->presentedFirstFrame) {
+		self->impl_->presentedFirstFrame = true;
+		RgWindow_LogStartupStep_(self, "first frame");
+	}
+
 	int width, height;
 	glfwGetFramebufferSize(self->impl_->window, &width, &height);
 	glViewport(0, 0, width, height);
 }
 
+static inline bool RgWindow_HasFrame_(RgWindow *self) {
+	return self->impl_->redraw || self->impl_->inputArrived || atomic_load(&self->impl_->woken);
+}
+
+static void RgWindow_WaitHeadless_(RgWindow *self, double timeout) {
+	struct timespec deadline;
+	if (timeout > 0.0) {
+		timespec_get(&deadline, TIME_UTC);
+		double seconds = deadline.tv_nsec / 1e9 + timeout;
+		deadline.tv_sec += (time_t)seconds;
+		deadline.tv_nsec = (long)((seconds - (double)(time_t)seconds) * 1e9);
+	}
+
+	mtx_lock(&self->impl_->wakeLock);
+	while (!atomic_load(&self->impl_->woken)) {
+		if (timeout <= 0.0) cnd_wait(&self->impl_->wakeCond, &self->impl_->wakeLock);
+		else if (cnd_timedwait(&self->impl_->wakeCond, &self->impl_->wakeLock, &deadline) == thrd_timedout) break;
+	}
+	mtx_unlock(&self->impl_->wakeLock);
+}
+
+bool RgWindow_BeginFrame(RgWindow *self, bool busy, double timeout) {
+	if (!busy && !RgWindow_HasFrame_(self) && !self->impl_->exposed) {
+		if (self->impl_->window == NULL) RgWindow_WaitHeadless_(self, timeout);
+		else if (timeout > 0.0) glfwWaitEventsTimeout(timeout);
+		else glfwWaitEvents();
+	}
+
+	// clear the wake-up in the same step that reads it, so a Wake from another thread isn't lost:
+	bool woken = atomic_exchange(&self->impl_->woken, false);
+	bool frame = busy || woken || self->impl_->redraw || self->impl_->inputArrived;
+
+	if (!frame && self->impl_->exposed) {
+		// the texture still holds the last frame, so only the swap has to be redone:
+		self->impl_->exposed = false;
+		RgWindow_Present_(self);
+	}
+
+	if (!frame) ++self->skippedFrames;
+	return frame;
+}
+
+void RgWindow_Wake(RgWindow *self) {
+	if (self->impl_->window == NULL) {
+		mtx_lock(&self->impl_->wakeLock);
+		atomic_store(&self->impl_->woken, true);
+		cnd_signal(&self->impl_->wakeCond);
+		mtx_unlock(&self->impl_->wakeLock);
+		return;
+	}
+
+	atomic_store(&self->impl_->woken, true);
+	glfwPostEmptyEvent();
+}
+
 bool RgWindow_IsKeyDown(RgWindow *self, RgKey key) {
+	if (self->impl_->window == NULL) return false;
 	return glfwGetKey(self->impl_->window, key);
 }
 
@@ -297,5 +584,6 @@ RgKeyState RgWindow_GetKeyState(RgWindow *self, RgKey key) {
 }
 
 float RgWindow_GetTime(RgWindow *self) {
+	if (self->impl_->window == NULL) return (RgTimeNs() - self->impl_->startTime) / 1e9;
 	return glfwGetTime();
 }
@@ -0,0 +1,107 @@
+#include <Rogue/World.h>
+#include <Rogue/Core.h>
+
+void RgWorld_Init(RgWorld *self, uint64_t seed) {
+	self->chunks = NULL;
+	self->chunkCount = self->chunkCapacity = 0;
+	self->entities = NULL;
+	self->entityCount = self->entityCapacity = 0;
+	self->chunkTable = NULL;
+	self->chunkTableCapacity = self->chunkTableCount = 0;
+	RgRng_Init(&self->rng, seed);
+}
+
+void RgWorld_DeInit(RgWorld *self) {
+	if (self->chunkCapacity != 0) RgDeAlloc(self->chunks);
+	if (self->entityCapacity != 0) RgDeAlloc(self->entities);
+	RgDeAlloc(self->chunkTable);
+	self->chunkTable = NULL;
+	self->chunkTableCapacity = self->chunkTableCount = 0;
+	self->chunks = NULL;
+	self->entities = NULL;
+	self->chunkCount = self->chunkCapacity = 0;
+	self->entityCount = self->entityCapacity = 0;
+}
+
+/* grows `array` to fit one more element. borrowed arrays (capacity 0) are copied on first write. */
+static void *RgWorld_Grow_(void *array, RgSize elemSize, RgSize count, RgSize *capacity) {
+	if (count < *capacity) return array;
+
+	RgSize newCapacity = Rg_Max(count * 2, (RgSize)16);
+	void *newArray = RgAllocArray(elemSize, newCapacity);
+	if (newArray == NULL) RgFail("Failed to grow world array to %zu elements.", newCapacity);
+
+	if (count != 0) __builtin_memcpy(newArray, array, elemSize * count);
+	if (*capacity != 0) RgDeAlloc(array);
+
+	*capacity = newCapacity;
+	return newArray;
+}
+
+RgChunk *RgWorld_AddChunk(RgWorld *self, int32_t x, int32_t y) {
+	self->chunks = RgWorld_Grow_(self->chunks, sizeof(*self->chunks), self->chunkCount, &self->chunkCapacity);
+	RgChunk *chunk = &self->chunks[self->chunkCount++];
+	RgMemFill(0, chunk, sizeof(*chunk));
+	chunk->x = x;
+	chunk->y = y;
+	return chunk;
+}
+
+static inline RgSize RgWorld_ChunkSlot_(int32_t x, int32_t y, RgSize capacity) {
+	uint64_t key = ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+	key *= 0x9E3779B97F4A7C15ull;
+	return (key ^ (key >> 32)) & (capacity - 1);
+}
+
+static void RgWorld_IndexChunk_(RgWorld *self, RgSize index) {
+	const RgChunk *chunk = &self->chunks[index];
+	RgSize slot = RgWorld_ChunkSlot_(chunk->x, chunk->y, self->chunkTableCapacity);
+	while (self->chunkTable[slot] != 0) slot = (slot + 1) & (self->chunkTableCapacity - 1);
+	self->chunkTable[slot] = (uint32_t)index + 1;
+}
+
+/* indexes chunks added since the last lookup, growing the table to stay at most half full. */
+static void RgWorld_UpdateChunkTable_(RgWorld *self) {
+	if (self->chunkTableCount == self->chunkCount) return;
+
+	if (self->chunkCount * 2 > self->chunkTableCapacity) {
+		RgSize capacity = Rg_Max(self->chunkTableCapacity, (RgSize)64);
+		while (self->chunkCount * 2 > capacity) capacity *= 2;
+
+		RgDeAlloc(self->chunkTable);
+		self->chunkTable = RgAllocArray(sizeof(*self->chunkTable), capacity);
+		if (self->chunkTable == NULL) RgFail("Failed to grow chunk table to %zu slots.", capacity);
+		self->chunkTableCapacity = capacity;
+		self->chunkTableCount = 0;
+	}
+
+	for (; self->chunkTableCount < self->chunkCount; ++self->chunkTableCount)
+		RgWorld_IndexChunk_(self, self->chunkTableCount);
+}
+
+RgChunk *RgWorld_GetChunk(RgWorld *self, int32_t x, int32_t y) {
+	RgWorld_UpdateChunkTable_(self);
+	if (self->chunkTableCapacity == 0) return NULL;
+
+	for (RgSize slot = RgWorld_ChunkSlot_(x, y, self->chunkTableCapacity);; slot = (slot + 1) & (self->chunkTableCapacity - 1)) {
+		uint32_t entry = self->chunkTable[slot];
+		if (entry == 0) return NULL;
+		RgChunk *chunk = &self->chunks[entry - 1];
+		if (chunk->x == x && chunk->y == y) return chunk;
+	}
+}
+
+RgTile *RgWorld_GetTile(RgWorld *self, int32_t x, int32_t y) {
+	int32_t chunkX = RgWorld_ChunkCoord(x), chunkY = RgWorld_ChunkCoord(y);
+
+	RgChunk *chunk = RgWorld_GetChunk(self, chunkX, chunkY);
+	if (chunk == NULL) return NULL;
+	return &chunk->tiles[(y - chunkY * RG_CHUNK_SIZE) * RG_CHUNK_SIZE + (x - chunkX * RG_CHUNK_SIZE)];
+}
+
+RgEntity *RgWorld_AddEntity(RgWorld *self) {
+	self->entities = RgWorld_Grow_(self->entities, sizeof(*self->entities), self->entityCount, &self->entityCapacity);
+	RgEntity *entity = &self->entities[self->entityCount++];
+	RgMemFill(0, entity, sizeof(*entity));
+	return entity;
+}
@@ -1,23 +1,40 @@
 #include <Rogue/Core.h>
 #include <Rogue/Window.h>
 #include <Rogue/Renderer.h>
-
-extern const uint8_t font8x8_basic[128][8];
-
-void ClearBuffer(RgRenderer *renderer, char c, uint8_t col) {
-	for (RgSize i = 0; i < renderer->width * renderer->height; ++i)
-		renderer->buffer[i] = (RgSymbol){ .value = c, .color = col };
-}
+#include <Rogue/Turn.h>
+#include <Rogue/Job.h>
+#include <Rogue/MapGen.h>
+#include <Rogue/Light.h>
+#include <Rogue/Spatial.h>
+#include <Rogue/Asset.h>
+#include <string.h>
 
 void ClearWindowBuffer(RgWindow *window, RgPixel color) {
-	for (RgSize i = 0; i < window->width * window->height; ++i)
+	for (RgSize i = 0; i < window->bufferWidth * window->bufferHeight; ++i)
 		window->buffer[i] = color;
 }
 
 static bool wasKeyDown[RG_KEY_MAX_] = {0};
 
+#define MAP_SEED 0x5EED
+#define MAP_STREAM_RADIUS 2 /* chunks kept generated around the player. */
+#define MAP_CHUNKS_PER_FRAME 4 /* generated chunks added to the map per frame. */
+#define LIGHT_WINDOW 64 /* side of the lit area around the player, in tiles. */
+#define LIGHT_MARGIN 16 /* the lit area recenters once the player is this close to its edge. */
+#define LIGHT_AMBIENT 0x404040
+#define FONT_PADDING 2 /* pixels between neighbouring glyphs. */
+
 typedef struct {
-	struct { RgInt x, y; } player;
+	struct { RgInt x, y; } player; /* in tiles. */
+	RgWorld map;
+	RgMapStreamer streamer;
+	RgLightMap light;
+	RgLight torch; /* carried by the player. */
+	RgSpatialGrid occupants; /* everything standing on a tile. */
+	RgSpatialNode playerNode;
+	RgTurnScheduler turns;
+	RgTurnActor playerTurn;
+	bool playerReady; /* it's the player's turn, waiting for input. */
 } World;
 
 static inline void DrawSymbol(RgRenderer *renderer, RgInt x, RgInt y, char c, uint8_t col) {
@@ -26,66 +43,211 @@ static inline void DrawSymbol(RgRenderer *renderer, RgInt x, RgInt y, char c, ui
 	renderer->buffer[x + y * renderer->width] = (RgSymbol){ .value = c, .color = col };
 }
 
+/* draws the map centered on the player. chunks that aren't generated yet stay blank. */
 void DrawWorld(World *world, RgRenderer *renderer, float deltaTime) {
-	DrawSymbol(renderer, world->player.x, world->player.y, '@', 1);
-	DrawSymbol(renderer, 10, 10, '~', 3);
-	DrawSymbol(renderer, 11, 10, '~', 3);
-	DrawSymbol(renderer, 10, 11, '~', 3);
-	DrawSymbol(renderer, 11, 11, '~', 3);
-	DrawSymbol(renderer, 10,  9, '~', 3);
-	DrawSymbol(renderer, 11,  9, '~', 3);
-	DrawSymbol(renderer,  9, 10, '~', 3);
-	DrawSymbol(renderer, 12,  9, '~', 3);
-	DrawSymbol(renderer, 11,  8, '~', 3);
-	DrawSymbol(renderer, 5, 8, '^', 2);
-
-	if (RgWindow_GetKeyState(renderer->window, RG_KEY_A) == RG_KEY_STATE_PRESS)
-		world->player.x -= 1;
-	else if (RgWindow_GetKeyState(renderer->window, RG_KEY_D) == RG_KEY_STATE_PRESS)
-		world->player.x += 1;
-
-	if (RgWindow_GetKeyState(renderer->window, RG_KEY_W) == RG_KEY_STATE_PRESS)
-		world->player.y -= 1;
-	else if (RgWindow_GetKeyState(renderer->window, RG_KEY_S) == RG_KEY_STATE_PRESS)
-		world->player.y += 1;
+	RgInt originX = world->player.x - (RgInt)renderer->width / 2;
+	RgInt originY = world->player.y - (RgInt)renderer->height / 2;
+
+	for (RgInt y = 0; y < renderer->height; ++y)
+	for (RgInt x = 0; x < renderer->width; ++x) {
+		const RgTile *tile = RgWorld_GetTile(&world->map, originX + x, originY + y);
+		if (tile != NULL) DrawSymbol(renderer, x, y, tile->glyph, tile->color);
+	}
+
+	DrawSymbol(renderer, world->player.x - originX, world->player.y - originY, '@', 1);
+}
+
+/* places the player on the walkable tile nearest to the middle of chunk (0, 0). */
+void SpawnPlayer(World *world) {
+	RgInt center = RG_CHUNK_SIZE / 2;
+	for (RgInt radius = 0; radius < RG_CHUNK_SIZE * MAP_STREAM_RADIUS; ++radius)
+	for (RgInt y = center - radius; y <= center + radius; ++y)
+	for (RgInt x = center - radius; x <= center + radius; ++x) {
+		const RgTile *tile = RgWorld_GetTile(&world->map, x, y);
+		if (tile == NULL || (tile->flags & RG_TILE_FLAG_SOLID)) continue;
+		world->player.x = x;
+		world->player.y = y;
+		return;
+	}
+	RgFail("No walkable tile near the spawn point.");
+}
+
+/* keeps the lit area around the player and the torch on the player, then relights what changed. */
+void UpdateLight(World *world, bool mapChanged) {
+	RgLightMap *light = &world->light;
+	RgInt localX = world->player.x - light->originX, localY = world->player.y - light->originY;
+
+	if (localX < LIGHT_MARGIN || localY < LIGHT_MARGIN
+		|| localX >= LIGHT_WINDOW - LIGHT_MARGIN || localY >= LIGHT_WINDOW - LIGHT_MARGIN) {
+		RgLightMap_SetOrigin(light, world->player.x - LIGHT_WINDOW / 2, world->player.y - LIGHT_WINDOW / 2, &world->map);
+	} else if (mapChanged) {
+		RgLightMap_SyncOpacity(light, &world->map);
+	}
+
+	RgLightMap_Move(light, &world->torch, world->player.x, world->player.y);
+	RgLightMap_Update(light);
+}
+
+/* switches to what a finished asset load produced, keeping the current font or palette if
+   loading it failed. the old font file is released right away, it isn't drawn from anymore. */
+void ApplyAssets(RgAssetLoad *load, RgWindow *window, RgFontFile *fontFile, RgFont *font, RgPixel *palette) {
+	if (load->fontLoaded) {
+		// the renderer only draws over the grid, so a new cell size would leave the old grid's
+		// border and glyphs around the new one:
+		ClearWindowBuffer(window, 0);
+		RgFontFile_DeInit(fontFile);
+		*fontFile = load->font;
+		load->fontLoaded = false;
+		*font = fontFile->font;
+		font->symbolWidth += FONT_PADDING;
+		font->symbolHeight += FONT_PADDING;
+	}
+	if (load->paletteLoaded)
+		memcpy(palette, load->palette.colors, sizeof(*palette) * load->palette.count);
+}
+
+/* returns whether the player took an action. */
+bool HandleInput(World *world, RgWindow *window) {
+	RgInt dx = 0, dy = 0;
+
+	if (RgWindow_GetKeyState(window, RG_KEY_A) == RG_KEY_STATE_PRESS)
+		dx = -1;
+	else if (RgWindow_GetKeyState(window, RG_KEY_D) == RG_KEY_STATE_PRESS)
+		dx = 1;
+
+	if (RgWindow_GetKeyState(window, RG_KEY_W) == RG_KEY_STATE_PRESS)
+		dy = -1;
+	else if (RgWindow_GetKeyState(window, RG_KEY_S) == RG_KEY_STATE_PRESS)
+		dy = 1;
+
+	if (dx == 0 && dy == 0) return false;
+
+	const RgTile *tile = RgWorld_GetTile(&world->map, world->player.x + dx, world->player.y + dy);
+	if (tile == NULL || (tile->flags & RG_TILE_FLAG_SOLID)) return false;
+	if (RgSpatialGrid_IsOccupied(&world->occupants, world->player.x + dx, world->player.y + dy)) return false;
+
+	world->player.x += dx;
+	world->player.y += dy;
+	RgSpatialGrid_Move(&world->occupants, &world->playerNode, world->player.x, world->player.y);
+	return true;
+}
+
+/* runs everyone else's turns until the player is up again. */
+void AdvanceTurns(World *world) {
+	while (!world->playerReady) {
+		RgTurnActor **batch;
+		RgSize count = RgTurnScheduler_NextBatch(&world->turns, &batch);
+		if (count == 0) RgFail("Nobody is left to take a turn.");
+
+		for (RgSize i = 0; i < count; ++i)
+			if (batch[i] == &world->playerTurn) world->playerReady = true;
+	}
 }
 
 int main(int argc, char *argv[]) {
+	bool printStartupTimes = false, printFrameStats = false;
+	const char *fontPath = NULL, *palettePath = NULL;
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--startup-times") == 0) printStartupTimes = true;
+		else if (strcmp(argv[i], "--frame-stats") == 0) printFrameStats = true;
+		else if (strcmp(argv[i], "--font") == 0 && i + 1 < argc) fontPath = argv[++i];
+		else if (strcmp(argv[i], "--palette") == 0 && i + 1 < argc) palettePath = argv[++i];
+		else RgFail("Unknown argument: %s", argv[i]);
+	}
+
+	RgJobSystem jobs;
+	RgJobSystem_Init(&jobs, &(RgJobSystemInitInfo){0});
+
+	// fonts and palettes load while the window comes up. until they are in, the built-in ones are
+	// drawn:
+	bool hasAssetFiles = fontPath != NULL || palettePath != NULL, assetsLoading = hasAssetFiles;
+	RgAssetLoad assetLoad = {0};
+	if (hasAssetFiles) RgAssetLoad_Start(&assetLoad, &jobs, fontPath, palettePath);
+
 	RgWindow window;
 	RgWindow_Init(&window, &(RgWindowInitInfo){
 		.width = 640,
 		.height = 480,
 		.scaleX = 2.0f,
 		.scaleY = 2.0f,
+#ifdef NDEBUG
+		.debugContext = false,
+#else
+		.debugContext = true,
+#endif
+		.printStartupTimes = printStartupTimes,
+		.shaderCacheDir = ".rg-cache",
 	});
 
-	RgFont font = {
-		.symbolWidth = 10, .symbolHeight = 10,
-		.fontAsciiMap = NULL,
-		.symbolCount = 128,
-		.symbolBitmaps = (const uint8_t*)font8x8_basic
-	};
+	RgFont font;
+	RgFont_InitBuiltin(&font, 8 + FONT_PADDING, 8 + FONT_PADDING);
+	RgFontFile fontFile = {0};
 
 	RgRenderer renderer;
 	RgRenderer_Init(&renderer, &window, 16, 16, &font);
-	renderer.palette = (uint32_t[]){
+	// every color a symbol can refer to, so a palette file with fewer colors keeps the rest:
+	RgPixel palette[256] = {
 		0x000000,
 		0xEEEEEE,
 		0x2112E2,
 		0xE22112,
-		0
 	};
+	renderer.palette = palette;
 
 	World world = {0};
-	world.player.y = 2;
+	RgWorld_Init(&world.map, MAP_SEED);
+	RgMapStreamer_Init(&world.streamer, &jobs, MAP_SEED);
+	RgMapStreamer_RequestAround(&world.streamer, 0, 0, MAP_STREAM_RADIUS);
+	RgMapStreamer_Flush(&world.streamer, &world.map);
+	SpawnPlayer(&world);
+	RgSpatialGrid_Init(&world.occupants);
+	RgSpatialGrid_Insert(&world.occupants, &world.playerNode, world.player.x, world.player.y);
+
+	RgLightMap_Init(&world.light, LIGHT_WINDOW, LIGHT_WINDOW, LIGHT_AMBIENT);
+	RgLightMap_SetOrigin(&world.light, world.player.x - LIGHT_WINDOW / 2, world.player.y - LIGHT_WINDOW / 2, &world.map);
+	world.torch = (RgLight){ .x = world.player.x, .y = world.player.y, .radius = 8, .color = 0x90C8FF };
+	RgLightMap_Add(&world.light, &world.torch);
+
+	RgPixel *viewLight = RgAllocArray(sizeof(*viewLight), renderer.width * renderer.height);
+	renderer.light = viewLight;
+
+	RgTurnScheduler_Init(&world.turns);
+	RgTurnScheduler_Add(&world.turns, &world.playerTurn, RG_TURN_NORMAL_SPEED, 0);
+	AdvanceTurns(&world);
 
 	float lastTime = RgWindow_GetTime(&window);
 
 	while (!RgWindow_ShouldStop(&window)) {
+		// sleep until there is input, unless chunks or assets are still loading:
+		bool busy = RgMapStreamer_IsBusy(&world.streamer) || assetsLoading;
+		if (!RgWindow_BeginFrame(&window, busy, 0.0)) continue;
+
+		// F5 reloads the font and palette files in the background, the swap happens between frames:
+		if (assetsLoading && RgAssetLoad_IsDone(&assetLoad)) {
+			ApplyAssets(&assetLoad, &window, &fontFile, &font, palette);
+			RgAssetLoad_DeInit(&assetLoad);
+			assetsLoading = false;
+		} else if (hasAssetFiles && !assetsLoading && RgWindow_GetKeyState(&window, RG_KEY_F5) == RG_KEY_STATE_PRESS) {
+			RgAssetLoad_Start(&assetLoad, &jobs, fontPath, palettePath);
+			assetsLoading = true;
+		}
+
 		float currentTime = RgWindow_GetTime(&window);
 		float deltaTime = currentTime - lastTime;
 
-		ClearBuffer(&renderer, '\0', 0);
+		if (world.playerReady && HandleInput(&world, &window)) {
+			world.playerReady = false;
+			AdvanceTurns(&world);
+		}
+
+		RgMapStreamer_RequestAround(&world.streamer,
+			RgWorld_ChunkCoord(world.player.x), RgWorld_ChunkCoord(world.player.y), MAP_STREAM_RADIUS);
+		RgSize arrived = RgMapStreamer_Drain(&world.streamer, &world.map, MAP_CHUNKS_PER_FRAME);
+		UpdateLight(&world, arrived != 0);
+		RgLightMap_Read(&world.light, world.player.x - (RgInt)renderer.width / 2, world.player.y - (RgInt)renderer.height / 2,
+			renderer.width, renderer.height, viewLight);
+
+		RgRenderer_Clear(&renderer, '\0', 0);
 		DrawWorld(&world, &renderer, deltaTime);
 
 		renderer.screenOffset.x
@@ -97,6 +259,18 @@ int main(int argc, char *argv[]) {
 		RgWindow_Refresh(&window);
 	}
 
+	if (printFrameStats)
+		RgLogInfo("frames: %zu presented, %zu skipped", window.presentedFrames, window.skippedFrames);
+
+	RgTurnScheduler_DeInit(&world.turns);
+	RgDeAlloc(viewLight);
+	RgLightMap_DeInit(&world.light);
+	RgSpatialGrid_DeInit(&world.occupants);
+	RgMapStreamer_DeInit(&world.streamer);
+	RgWorld_DeInit(&world.map);
+	RgAssetLoad_DeInit(&assetLoad);
+	RgJobSystem_DeInit(&jobs);
 	RgRenderer_DeInit(&renderer);
+	RgFontFile_DeInit(&fontFile);
 	RgWindow_DeInit(&window);
 }